@@ -87,6 +87,74 @@ describe('The /query endpoint', () => {
     );
   });
 
+  it('should return the following pages of a Details query with the continuation token', async () => {
+    const detailsQuery = (limit, continuationToken) => ({
+      action: {
+        type: 'Details',
+        fields: ['gisaid_epi_isl', 'date'],
+        orderByFields: ['date'],
+        limit,
+        ...(continuationToken !== undefined && { continuationToken }),
+      },
+      filterExpression: { type: 'True' },
+    });
+    const parseLines = response =>
+      response.text
+        .split(/\n/)
+        .filter(it => it !== '')
+        .map(it => JSON.parse(it));
+
+    const bothPages = await server.post('/query').send(detailsQuery(6)).expect(200);
+    const firstPage = await server.post('/query').send(detailsQuery(3)).expect(200);
+    expect(firstPage.headers).to.have.property('continuation-token');
+    const secondPage = await server
+      .post('/query')
+      .send(detailsQuery(3, firstPage.headers['continuation-token']))
+      .expect(200);
+
+    expect([...parseLines(firstPage), ...parseLines(secondPage)]).to.deep.equal(
+      parseLines(bothPages)
+    );
+  });
+
+  it('should reject a continuation token of a query with another order or filter', async () => {
+    const detailsQuery = (orderByFields, filterExpression, continuationToken) => ({
+      action: {
+        type: 'Details',
+        fields: ['gisaid_epi_isl', 'date'],
+        orderByFields,
+        limit: 3,
+        ...(continuationToken !== undefined && { continuationToken }),
+      },
+      filterExpression,
+    });
+    const expectedError = {
+      error: 'Bad request',
+      message:
+        'The continuationToken belongs to a query with other orderByFields or another ' +
+        'filterExpression. The pagination has to be restarted.',
+    };
+
+    const firstPage = await server
+      .post('/query')
+      .send(detailsQuery(['date'], { type: 'True' }))
+      .expect(200);
+    const continuationToken = firstPage.headers['continuation-token'];
+    const descendingDate = [{ field: 'date', order: 'descending' }];
+    const swissFilter = { type: 'StringEquals', column: 'country', value: 'Switzerland' };
+
+    await server
+      .post('/query')
+      .send(detailsQuery(descendingDate, { type: 'True' }, continuationToken))
+      .expect(400)
+      .expect(expectedError);
+    await server
+      .post('/query')
+      .send(detailsQuery(['date'], swissFilter, continuationToken))
+      .expect(400)
+      .expect(expectedError);
+  });
+
   it('should return a method not allowed response when sending a GET request', async () => {
     await server.get('/query').send().expect(405).expect('Content-Type', 'application/json').expect({
       error: 'Method not allowed',
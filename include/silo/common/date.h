@@ -14,4 +14,16 @@ silo::common::Date stringToDate(const std::string& value);
 
 std::optional<std::string> dateToString(silo::common::Date date);
 
+/// Calendar units to which dates can be truncated. Weeks are ISO weeks, starting on Monday.
+enum class DateTruncation { DAY, WEEK, MONTH, QUARTER, YEAR };
+
+/// Returns the first date of the unit that contains the date. NULL_DATE stays NULL_DATE.
+silo::common::Date truncateDate(silo::common::Date date, DateTruncation truncation);
+
+/// Number of days since 1970-01-01, so that differences of dates are numbers of days. Must not
+/// be called with NULL_DATE.
+int32_t dateToDays(silo::common::Date date);
+
+silo::common::Date daysToDate(int32_t days);
+
 }  // namespace silo::common
@@ -16,6 +16,7 @@ const std::string MAX_CONNECTIONS_OPTION = "maxQueuedHttpConnections";
 const std::string PARALLEL_THREADS_OPTION = "threadsForHttpConnections";
 const std::string PORT_OPTION = "port";
 const std::string ESTIMATED_STARTUP_TIME_IN_MINUTES_OPTION = "estimatedStartupTimeInMinutes";
+const std::string MAX_STREAMED_SEQUENCES_OPTION = "maxStreamedSequences";
 
 struct RuntimeConfig {
    std::filesystem::path data_directory = silo::config::DEFAULT_OUTPUT_DIRECTORY;
@@ -24,6 +25,9 @@ struct RuntimeConfig {
    uint16_t port = 8081;
    std::optional<std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds>>
       estimated_startup_end;
+   /// The upper bound for the entries of a streamed query result. A query holds the database
+   /// until its result is written, which blocks loading a new database for that long.
+   uint32_t max_streamed_sequences = 1'000'000;
 
    void overwrite(const silo::config::AbstractConfig& config);
 };
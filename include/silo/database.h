@@ -3,6 +3,7 @@
 #include <cstddef>
 #include <filesystem>
 #include <map>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
@@ -18,6 +19,10 @@
 #include "silo/storage/sequence_store.h"
 #include "silo/storage/unaligned_sequence_store.h"
 
+namespace duckdb {
+class DuckDB;
+}  // namespace duckdb
+
 namespace silo {
 class BitmapContainerSize;
 class BitmapSizePerSymbol;
@@ -48,6 +53,8 @@ class Database {
    std::map<std::string, SequenceStore<Nucleotide>> nuc_sequences;
    std::map<std::string, SequenceStore<AminoAcid>> aa_sequences;
    std::map<std::string, UnalignedSequenceStore> unaligned_nuc_sequences;
+   /// Long-lived DuckDB instance through which the unaligned sequence files are read
+   std::shared_ptr<duckdb::DuckDB> unaligned_sequences_duckdb;
 
   private:
    PangoLineageAliasLookup alias_key;
@@ -92,6 +99,7 @@ class Database {
       const std::map<std::string, std::vector<AminoAcid::Symbol>>& reference_sequences
    );
    void finalizeInsertionIndexes();
+   void buildRowSamples();
 
    template <typename SymbolType>
    static BitmapSizePerSymbol calculateBitmapSizePerSymbol(
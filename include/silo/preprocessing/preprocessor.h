@@ -80,6 +80,7 @@ class Preprocessor {
       const preprocessing::Partitions& partition_descriptor,
       const std::string& order_by_clause
    );
+   void buildUnalignedSequenceStore(Database& database, const std::string& order_by_clause);
    void buildAminoAcidSequenceStore(
       Database& database,
       const preprocessing::Partitions& partition_descriptor,
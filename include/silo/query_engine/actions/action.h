@@ -29,6 +29,8 @@ class Action {
    std::optional<uint32_t> limit;
    std::optional<uint32_t> offset;
    std::optional<uint32_t> randomize_seed;
+   /// The filterExpression of the query as compact JSON, for actions whose results are tied to it
+   std::string filter_expression;
 
    void applySort(QueryResult& result) const;
    void applyOffsetAndLimit(QueryResult& result) const;
@@ -51,6 +53,8 @@ class Action {
       std::optional<uint32_t> randomize_seed
    );
 
+   void setFilterExpression(std::string filter_expression);
+
    [[nodiscard]] virtual QueryResult executeAndOrder(
       const Database& database,
       std::vector<OperatorResult> bitmap_filter
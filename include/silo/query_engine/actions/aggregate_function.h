@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <variant>
+#include <vector>
+
+#include <nlohmann/json_fwd.hpp>
+
+#include "silo/common/json_value_type.h"
+#include "silo/storage/column_group.h"
+
+namespace silo {
+class Database;
+}  // namespace silo
+
+namespace silo::query_engine::actions {
+
+enum class AggregateFunctionType { SUM, MIN, MAX, MEAN, COUNT_DISTINCT };
+
+/// An aggregate function over an INT, FLOAT or DATE column, e.g. {"function": "max", "field":
+/// "date"}. Its result is returned in the field `<function>_<field>`, e.g. `max_date`.
+struct AggregateFunction {
+   AggregateFunctionType type;
+   std::string field;
+
+   [[nodiscard]] std::string getResultName() const;
+
+   void validate(const Database& database) const;
+};
+
+/// Mergeable partial state of one aggregate function in one group. Null values are skipped.
+/// Every function only keeps the state it needs, as there is one state per group and function.
+class AggregateState {
+   /// For sum and mean
+   struct SumState {
+      uint32_t value_count = 0;
+      double sum = 0;
+   };
+   struct MinState {
+      std::optional<double> min;
+   };
+   struct MaxState {
+      std::optional<double> max;
+   };
+   /// The set is only allocated once the group has a value
+   struct DistinctState {
+      std::unique_ptr<std::unordered_set<double>> values;
+   };
+
+   std::variant<SumState, MinState, MaxState, DistinctState> state;
+
+  public:
+   explicit AggregateState(AggregateFunctionType type);
+
+   void add(double value);
+
+   AggregateState& operator+=(AggregateState&& other);
+
+   [[nodiscard]] common::JsonValueType getResult(
+      AggregateFunctionType type,
+      silo::config::ColumnType column_type
+   ) const;
+};
+
+/// The partial aggregation of one group
+struct GroupAggregates {
+   uint32_t count = 0;
+   std::vector<AggregateState> states;
+
+   GroupAggregates& operator+=(GroupAggregates&& other);
+};
+
+/// Adds rows to the aggregate states of their group and writes the final results
+class Aggregator {
+   const std::vector<AggregateFunction>& functions;
+   std::vector<silo::storage::ColumnMetadata> metadata;
+
+  public:
+   Aggregator(const std::vector<AggregateFunction>& functions, const Database& database);
+
+   void add(
+      GroupAggregates& group,
+      const silo::storage::ColumnPartitionGroup& columns,
+      uint32_t row
+   ) const;
+
+   [[nodiscard]] common::JsonValueType getResult(const GroupAggregates& group, size_t index)
+      const;
+
+   void writeResult(
+      const GroupAggregates& group,
+      std::map<std::string, common::JsonValueType>& fields
+   ) const;
+};
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void from_json(const nlohmann::json& json, AggregateFunction& function);
+
+}  // namespace silo::query_engine::actions
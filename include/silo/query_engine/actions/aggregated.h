@@ -1,12 +1,16 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
 #include <nlohmann/json_fwd.hpp>
 
+#include "silo/common/date.h"
 #include "silo/query_engine/actions/action.h"
+#include "silo/query_engine/actions/aggregate_function.h"
+#include "silo/query_engine/actions/approximation.h"
 #include "silo/query_engine/query_result.h"
 
 namespace silo {
@@ -19,9 +23,24 @@ class OperatorResult;
 
 namespace silo::query_engine::actions {
 
+/// A date field of the groupByFields whose values are grouped by a calendar unit, e.g.
+/// {"field": "date", "truncateTo": "month"}. Groups hold the first date of their unit.
+struct TruncatedDateField {
+   std::string name;
+   common::DateTruncation truncation;
+};
+
 class Aggregated : public Action {
   private:
    std::vector<std::string> group_by_fields;
+   std::optional<TruncatedDateField> truncated_date_field;
+   std::vector<AggregateFunction> aggregates;
+   std::optional<Approximation> approximation;
+
+   [[nodiscard]] QueryResult executeExact(
+      const Database& database,
+      std::vector<OperatorResult>& bitmap_filters
+   ) const;
 
    [[nodiscard]] void validateOrderByFields(const Database& database) const override;
 
@@ -31,7 +50,12 @@ class Aggregated : public Action {
    ) const override;
 
   public:
-   Aggregated(std::vector<std::string> group_by_fields);
+   Aggregated(
+      std::vector<std::string> group_by_fields,
+      std::optional<TruncatedDateField> truncated_date_field,
+      std::vector<AggregateFunction> aggregates,
+      std::optional<Approximation> approximation = std::nullopt
+   );
 };
 
 // NOLINTNEXTLINE(readability-identifier-naming)
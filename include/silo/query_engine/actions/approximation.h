@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json_fwd.hpp>
+
+namespace silo {
+class Database;
+}  // namespace silo
+
+namespace silo::query_engine {
+class OperatorResult;
+}  // namespace silo::query_engine
+
+namespace silo::query_engine::actions {
+
+/// Opt-in approximate evaluation of an action: the action is evaluated over a sample of about
+/// sample_size to twice sample_size of the filtered rows and its counts are scaled up to all
+/// filtered rows
+struct Approximation {
+   static constexpr uint32_t DEFAULT_SAMPLE_SIZE = 100'000;
+
+   uint32_t sample_size = DEFAULT_SAMPLE_SIZE;
+};
+
+/// A count over all filtered rows, estimated from the count in the sample, with the bounds of
+/// its 95% confidence interval
+struct CountEstimate {
+   uint64_t count;
+   uint64_t lower;
+   uint64_t upper;
+};
+
+/// A proportion estimated from a sample, with the bounds of its 95% confidence interval
+struct ProportionEstimate {
+   double proportion;
+   double lower;
+   double upper;
+};
+
+/// The filtered rows and the sample of them that an approximate action is evaluated on
+struct FilterSample {
+   uint64_t population;
+   uint64_t sample_size;
+
+   /// The sample contains all filtered rows, i.e. the filter was small enough to be exact
+   [[nodiscard]] bool isExact() const;
+
+   [[nodiscard]] CountEstimate estimateCount(uint64_t sample_count) const;
+
+   /// The proportion of sample_count in sample_total rows of the sample
+   [[nodiscard]] ProportionEstimate estimateProportion(uint64_t sample_count, uint64_t sample_total)
+      const;
+};
+
+/// Replaces the filters by a deterministic sample of about approximation.sample_size to twice
+/// approximation.sample_size of their rows, by intersecting them with the deepest level of the
+/// precomputed row samples of the partitions that is still large enough. Therefore, the same query
+/// always sees the same sample. Filters with less than twice sample_size rows stay unchanged.
+FilterSample sampleFilter(
+   const Database& database,
+   std::vector<OperatorResult>& bitmap_filter,
+   const Approximation& approximation
+);
+
+/// Parses the field 'approximate' of an action, which is either a bool or an object
+/// {"sampleSize": number}
+std::optional<Approximation> parseApproximation(
+   const nlohmann::json& json,
+   const std::string& action_name
+);
+
+}  // namespace silo::query_engine::actions
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <roaring/roaring.hh>
+
+#include "silo/common/date.h"
+
+namespace silo::preprocessing {
+struct PartitionChunk;
+}  // namespace silo::preprocessing
+
+namespace silo::query_engine::actions {
+
+extern const std::map<std::string, common::DateTruncation> DATE_TRUNCATION_NAMES;
+
+/// A range of rows of a sorted date column, whose dates are truncated to the same date
+struct TruncatedDateRun {
+   common::Date date;
+   uint32_t begin;
+   uint32_t end;
+};
+
+/// Sorted date columns are sorted within every chunk, so the rows with equal truncated dates form
+/// runs, which are found by binary search instead of truncating the date of every row
+std::vector<TruncatedDateRun> getTruncatedDateRuns(
+   const std::vector<common::Date>& dates,
+   const std::vector<preprocessing::PartitionChunk>& chunks,
+   common::DateTruncation truncation
+);
+
+/// Number of rows in [begin, end), where end > 0
+uint64_t countRowsInRange(const roaring::Roaring& rows, uint32_t begin, uint32_t end);
+
+}  // namespace silo::query_engine::actions
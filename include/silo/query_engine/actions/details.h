@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -18,16 +20,49 @@ class OperatorResult;
 
 namespace silo::query_engine::actions {
 
+/// The last row of a page of a Details query, after which the next page starts. It is passed
+/// between the pages as an opaque continuation token. The row is identified by its position in
+/// the database of the data version, its primary key guards against tokens of other databases.
+/// The orderByFields and the hash of the filter guard against tokens of other queries, whose
+/// pages would not continue after this row.
+struct DetailsCursor {
+   std::string data_version;
+   uint32_t partition_id;
+   uint32_t row;
+   std::string primary_key;
+   std::vector<OrderByField> order_by_fields;
+   uint64_t filter_hash;
+
+   [[nodiscard]] std::string toContinuationToken() const;
+
+   static DetailsCursor fromContinuationToken(const std::string& continuation_token);
+};
+
+/// A uniform sample of the filtered rows, drawn without replacement. Equal seeds draw equal
+/// samples of the same data version.
+struct DetailsSample {
+   uint32_t size;
+   uint32_t seed;
+};
+
 class Details : public Action {
    std::vector<std::string> fields;
+   std::optional<DetailsCursor> cursor;
+   std::optional<DetailsSample> sample;
 
    [[nodiscard]] void validateOrderByFields(const Database& database) const override;
 
+   void validateCursor(const Database& database) const;
+
    QueryResult execute(const Database& database, std::vector<OperatorResult> bitmap_filter)
       const override;
 
   public:
-   explicit Details(std::vector<std::string> fields);
+   explicit Details(
+      std::vector<std::string> fields,
+      std::optional<DetailsCursor> cursor = std::nullopt,
+      std::optional<DetailsSample> sample = std::nullopt
+   );
 
    QueryResult executeAndOrder(const Database& database, std::vector<OperatorResult> bitmap_filter)
       const override;
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json_fwd.hpp>
+
+#include "silo/query_engine/actions/action.h"
+#include "silo/query_engine/query_result.h"
+
+namespace silo {
+class Database;
+}  // namespace silo
+namespace silo::query_engine {
+class OperatorResult;
+}  // namespace silo::query_engine
+
+namespace silo::query_engine::actions {
+
+/// The Shannon entropy (in bits) of the symbols at every position over the filtered sequences,
+/// together with the coverage, i.e. the number of sequences with a valid symbol at the position.
+/// Only positions with coverage and an entropy of at least min_entropy are returned.
+template <typename SymbolType>
+class Diversity : public Action {
+   std::vector<std::string> sequence_names;
+   double min_entropy;
+
+   const std::string POSITION_FIELD_NAME = "position";
+   const std::string SEQUENCE_FIELD_NAME = "sequenceName";
+   const std::string ENTROPY_FIELD_NAME = "entropy";
+   const std::string COVERAGE_FIELD_NAME = "coverage";
+
+   void validateOrderByFields(const Database& database) const override;
+
+   [[nodiscard]] QueryResult execute(
+      const Database& database,
+      std::vector<OperatorResult> bitmap_filter
+   ) const override;
+
+  public:
+   Diversity(std::vector<std::string>&& sequence_names, double min_entropy);
+};
+
+template <typename SymbolType>
+// NOLINTNEXTLINE(readability-identifier-naming)
+void from_json(const nlohmann::json& json, std::unique_ptr<Diversity<SymbolType>>& action);
+
+}  // namespace silo::query_engine::actions
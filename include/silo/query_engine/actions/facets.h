@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json_fwd.hpp>
+
+#include "silo/query_engine/actions/action.h"
+#include "silo/query_engine/query_result.h"
+
+namespace silo {
+class Database;
+}  // namespace silo
+namespace silo::query_engine {
+class OperatorResult;
+}  // namespace silo::query_engine
+
+namespace silo::query_engine::actions {
+
+/// Counts the filtered rows per value of every one of the given fields, e.g. for the filter
+/// sidebar of a search page. All distributions are computed from one evaluation of the filter.
+/// Within a facet, values are ordered by descending count.
+class Facets : public Action {
+   std::vector<std::string> fields;
+   std::optional<uint32_t> limit_per_facet;
+
+   const std::string FIELD_FIELD_NAME = "field";
+   const std::string VALUE_FIELD_NAME = "value";
+   const std::string COUNT_FIELD_NAME = "count";
+
+   void validateOrderByFields(const Database& database) const override;
+
+   [[nodiscard]] QueryResult execute(
+      const Database& database,
+      std::vector<OperatorResult> bitmap_filter
+   ) const override;
+
+  public:
+   Facets(std::vector<std::string> fields, std::optional<uint32_t> limit_per_facet);
+};
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void from_json(const nlohmann::json& json, std::unique_ptr<Facets>& action);
+
+}  // namespace silo::query_engine::actions
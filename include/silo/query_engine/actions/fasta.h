@@ -20,26 +20,29 @@ class DatabasePartition;
 namespace silo::query_engine::actions {
 
 class Fasta : public Action {
+   /// The limit for results that are materialized to be ordered
    static constexpr size_t SEQUENCE_LIMIT = 10'000;
+   static constexpr size_t STREAMING_CHUNK_SIZE = 1'000;
 
    std::vector<std::string> sequence_names;
 
    void validateOrderByFields(const Database& database) const override;
 
+   void validateSequenceNames(const Database& database) const;
+
    [[nodiscard]] QueryResult execute(
       const Database& database,
       std::vector<OperatorResult> bitmap_filter
    ) const override;
 
-   void addSequencesToResultsForPartition(
-      QueryResult& results,
-      const silo::DatabasePartition& database_partition,
-      const OperatorResult& bitmap,
-      const std::string& primary_key_column
-   ) const;
-
   public:
    explicit Fasta(std::vector<std::string>&& sequence_names);
+
+   /// Streams the sequences in row order unless the result has to be ordered
+   [[nodiscard]] QueryResult executeAndOrder(
+      const Database& database,
+      std::vector<OperatorResult> bitmap_filter
+   ) const override;
 };
 
 // NOLINTNEXTLINE(readability-identifier-naming)
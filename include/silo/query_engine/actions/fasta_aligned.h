@@ -19,15 +19,36 @@ class Database;
 namespace silo::query_engine::actions {
 
 class FastaAligned : public Action {
+   /// The limit for results that are materialized to be ordered
+   static constexpr size_t SEQUENCE_LIMIT = 10'000;
+   static constexpr size_t STREAMING_CHUNK_SIZE = 100;
+
    std::vector<std::string> sequence_names;
+   /// Return the differences to the reference instead of the full sequences
+   bool differences_to_reference;
 
    void validateOrderByFields(const Database& database) const override;
 
+   void splitSequenceNames(
+      const Database& database,
+      std::vector<std::string>& nuc_sequence_names,
+      std::vector<std::string>& aa_sequence_names
+   ) const;
+
    QueryResult execute(const Database& database, std::vector<OperatorResult> bitmap_filter)
       const override;
 
   public:
-   explicit FastaAligned(std::vector<std::string>&& sequence_names);
+   explicit FastaAligned(
+      std::vector<std::string>&& sequence_names,
+      bool differences_to_reference = false
+   );
+
+   /// Streams the sequences in row order unless the result has to be ordered
+   [[nodiscard]] QueryResult executeAndOrder(
+      const Database& database,
+      std::vector<OperatorResult> bitmap_filter
+   ) const override;
 };
 
 // NOLINTNEXTLINE(readability-identifier-naming)
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <variant>
+#include <vector>
+
+#include <nlohmann/json_fwd.hpp>
+
+#include "silo/query_engine/actions/action.h"
+#include "silo/query_engine/query_result.h"
+
+namespace silo {
+class Database;
+}  // namespace silo
+namespace silo::query_engine {
+class OperatorResult;
+}  // namespace silo::query_engine
+
+namespace silo::query_engine::actions {
+
+/// Counts the filtered rows per bucket of the values of an INT, FLOAT or DATE field. Buckets
+/// contain their lowerBound, but not their upperBound. They are either given by their boundaries
+/// or bucketCount buckets of equal width between the minimum and maximum value. For FLOAT fields,
+/// the last of the equal-width buckets also contains the maximum. Null values are counted in a
+/// bucket with null bounds.
+class Histogram : public Action {
+   std::string field;
+   uint32_t bucket_count;
+   /// Numbers, or date strings for DATE fields
+   std::vector<std::variant<double, std::string>> bucket_boundaries;
+
+   const std::string LOWER_BOUND_FIELD_NAME = "lowerBound";
+   const std::string UPPER_BOUND_FIELD_NAME = "upperBound";
+   const std::string COUNT_FIELD_NAME = "count";
+
+   void validateOrderByFields(const Database& database) const override;
+
+   [[nodiscard]] QueryResult execute(
+      const Database& database,
+      std::vector<OperatorResult> bitmap_filter
+   ) const override;
+
+  public:
+   static constexpr uint32_t DEFAULT_BUCKET_COUNT = 10;
+   static constexpr uint32_t BUCKET_LIMIT = 10'000;
+
+   Histogram(
+      std::string field,
+      uint32_t bucket_count,
+      std::vector<std::variant<double, std::string>> bucket_boundaries
+   );
+};
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void from_json(const nlohmann::json& json, std::unique_ptr<Histogram>& action);
+
+}  // namespace silo::query_engine::actions
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <roaring/roaring.hh>
+
+#include "silo/common/json_value_type.h"
+#include "silo/common/types.h"
+#include "silo/storage/column_group.h"
+
+namespace silo::query_engine::actions {
+
+bool isIndexedColumn(const silo::storage::ColumnMetadata& metadata);
+
+/// A view on the per-row value ids and the per-value bitmaps of an indexed column partition
+struct IndexedColumn {
+   const std::vector<silo::Idx>& value_ids;
+   const std::unordered_map<silo::Idx, roaring::Roaring>& value_bitmaps;
+};
+
+IndexedColumn getIndexedColumn(
+   const silo::storage::ColumnPartitionGroup& columns,
+   const silo::storage::ColumnMetadata& metadata
+);
+
+/// The number of rows per key of a partition. The key of a value is its value id combined with a
+/// key prefix, so that the values of several columns can be counted in one map.
+using IndexedValueCounts = std::unordered_map<uint64_t, uint32_t>;
+
+/// Adds the number of rows per value of the column to the counts, keyed by
+/// `key_prefix | value_id`
+void countIndexedValues(
+   const IndexedColumn& column,
+   const roaring::Roaring& rows,
+   bool rows_are_full_partition,
+   uint64_t key_prefix,
+   IndexedValueCounts& counts
+);
+
+/// The dictionaries of indexed columns are shared by all partitions, so value ids can be looked
+/// up in the columns of any partition
+silo::common::JsonValueType lookupIndexedValue(
+   const silo::storage::ColumnPartitionGroup& columns,
+   const silo::storage::ColumnMetadata& metadata,
+   silo::Idx value_id
+);
+
+}  // namespace silo::query_engine::actions
@@ -58,6 +58,7 @@ class InsertionAggregation : public Action {
    void addAllColumnIndexesToPreFilteredBitmaps(
       const silo::storage::column::InsertionColumnPartition<SymbolType>& column,
       const OperatorResult& filter,
+      bool filter_contains_all_rows,
       std::unordered_map<std::string, InsertionAggregation<SymbolType>::PrefilteredBitmaps>&
          bitmaps_to_evaluate
    ) const;
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json_fwd.hpp>
+
+#include "silo/query_engine/actions/action.h"
+#include "silo/query_engine/query_result.h"
+
+namespace silo {
+class Database;
+}  // namespace silo
+namespace silo::query_engine {
+class OperatorResult;
+}  // namespace silo::query_engine
+
+namespace silo::query_engine::actions {
+
+/// Counts for every pair of the given mutations the sequences that have both of them. The
+/// mutations are either listed explicitly or all mutations with at least min_proportion.
+template <typename SymbolType>
+class MutationCooccurrence : public Action {
+   static constexpr size_t MUTATION_LIMIT = 500;
+
+   std::optional<std::string> sequence_name;
+   std::vector<std::string> mutations;
+   std::optional<double> min_proportion;
+
+   const std::string MUTATION_A_FIELD_NAME = "mutationA";
+   const std::string MUTATION_B_FIELD_NAME = "mutationB";
+   const std::string SEQUENCE_FIELD_NAME = "sequenceName";
+   const std::string COUNT_FIELD_NAME = "count";
+
+   [[nodiscard]] std::vector<std::string> selectMutationsByProportion(
+      const Database& database,
+      const std::string& sequence_name_or_default,
+      const std::vector<OperatorResult>& bitmap_filter
+   ) const;
+
+   void validateOrderByFields(const Database& database) const override;
+
+   [[nodiscard]] QueryResult execute(
+      const Database& database,
+      std::vector<OperatorResult> bitmap_filter
+   ) const override;
+
+  public:
+   MutationCooccurrence(
+      std::optional<std::string> sequence_name,
+      std::vector<std::string>&& mutations,
+      std::optional<double> min_proportion
+   );
+};
+
+template <typename SymbolType>
+// NOLINTNEXTLINE(readability-identifier-naming)
+void from_json(
+   const nlohmann::json& json,
+   std::unique_ptr<MutationCooccurrence<SymbolType>>& action
+);
+
+}  // namespace silo::query_engine::actions
@@ -3,6 +3,7 @@
 #include <array>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -12,14 +13,14 @@
 
 #include "silo/common/symbol_map.h"
 #include "silo/query_engine/actions/action.h"
+#include "silo/query_engine/actions/approximation.h"
+#include "silo/query_engine/actions/symbol_counts.h"
 #include "silo/query_engine/query_result.h"
 
 namespace silo {
 class Database;
 template <typename SymbolType>
 class SequenceStore;
-template <typename SymbolType>
-class SequenceStorePartition;
 }  // namespace silo
 namespace silo::query_engine {
 class OperatorResult;
@@ -31,6 +32,7 @@ template <typename SymbolType>
 class Mutations : public Action {
    std::vector<std::string> sequence_names;
    double min_proportion;
+   std::optional<Approximation> approximation;
 
    const std::string MUTATION_FIELD_NAME = "mutation";
    const std::string MUTATION_FROM_FIELD_NAME = "mutationFrom";
@@ -39,38 +41,16 @@ class Mutations : public Action {
    const std::string SEQUENCE_FIELD_NAME = "sequenceName";
    const std::string PROPORTION_FIELD_NAME = "proportion";
    const std::string COUNT_FIELD_NAME = "count";
-
-   struct PrefilteredBitmaps {
-      std::vector<std::pair<const OperatorResult&, const silo::SequenceStorePartition<SymbolType>&>>
-         bitmaps;
-      std::vector<std::pair<const OperatorResult&, const silo::SequenceStorePartition<SymbolType>&>>
-         full_bitmaps;
-   };
-
-   static std::unordered_map<std::string, Mutations<SymbolType>::PrefilteredBitmaps>
-   preFilterBitmaps(const silo::Database& database, std::vector<OperatorResult>& bitmap_filter);
-
-   static void addPositionToMutationCountsForMixedBitmaps(
-      uint32_t position_idx,
-      const PrefilteredBitmaps& bitmaps_to_evaluate,
-      SymbolMap<SymbolType, std::vector<uint32_t>>& count_of_mutations_per_position
-   );
-
-   static void addPositionToMutationCountsForFullBitmaps(
-      uint32_t position_idx,
-      const PrefilteredBitmaps& bitmaps_to_evaluate,
-      SymbolMap<SymbolType, std::vector<uint32_t>>& count_of_mutations_per_position
-   );
-
-   static SymbolMap<SymbolType, std::vector<uint32_t>> calculateMutationsPerPosition(
-      const SequenceStore<SymbolType>& sequence_store,
-      const PrefilteredBitmaps& bitmap_filter
-   );
+   const std::string COUNT_LOWER_FIELD_NAME = "countLower";
+   const std::string COUNT_UPPER_FIELD_NAME = "countUpper";
+   const std::string PROPORTION_LOWER_FIELD_NAME = "proportionLower";
+   const std::string PROPORTION_UPPER_FIELD_NAME = "proportionUpper";
 
    void addMutationsToOutput(
       const std::string& sequence_name,
       const SequenceStore<SymbolType>& sequence_store,
-      const PrefilteredBitmaps& bitmap_filter,
+      const PrefilteredBitmaps<SymbolType>& bitmap_filter,
+      const std::optional<FilterSample>& filter_sample,
       std::vector<QueryResultEntry>& output
    ) const;
 
@@ -82,7 +62,11 @@ class Mutations : public Action {
    ) const override;
 
   public:
-   explicit Mutations(std::vector<std::string>&& aa_sequence_names, double min_proportion);
+   explicit Mutations(
+      std::vector<std::string>&& aa_sequence_names,
+      double min_proportion,
+      std::optional<Approximation> approximation = std::nullopt
+   );
 };
 
 template <typename SymbolType>
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json_fwd.hpp>
+
+#include "silo/common/date.h"
+#include "silo/query_engine/actions/action.h"
+#include "silo/query_engine/query_result.h"
+
+namespace silo {
+class Database;
+}  // namespace silo
+namespace silo::query_engine {
+class OperatorResult;
+}  // namespace silo::query_engine
+
+namespace silo::query_engine::actions {
+
+/// Counts the sequences with each of the given mutations per truncated date, together with the
+/// coverage, i.e. the sequences of that date with a valid mutation symbol at the position. Like in
+/// the Mutations and Diversity actions, missing and ambiguous symbols are not covered.
+template <typename SymbolType>
+class MutationsOverTime : public Action {
+   static constexpr size_t MUTATION_LIMIT = 1'000;
+
+   std::optional<std::string> sequence_name;
+   std::vector<std::string> mutations;
+   std::string date_field;
+   common::DateTruncation truncation;
+
+   const std::string MUTATION_FIELD_NAME = "mutation";
+   const std::string SEQUENCE_FIELD_NAME = "sequenceName";
+   const std::string COUNT_FIELD_NAME = "count";
+   const std::string COVERAGE_FIELD_NAME = "coverage";
+
+   void validateOrderByFields(const Database& database) const override;
+
+   [[nodiscard]] QueryResult execute(
+      const Database& database,
+      std::vector<OperatorResult> bitmap_filter
+   ) const override;
+
+  public:
+   MutationsOverTime(
+      std::optional<std::string> sequence_name,
+      std::vector<std::string>&& mutations,
+      std::string date_field,
+      common::DateTruncation truncation
+   );
+};
+
+template <typename SymbolType>
+// NOLINTNEXTLINE(readability-identifier-naming)
+void from_json(const nlohmann::json& json, std::unique_ptr<MutationsOverTime<SymbolType>>& action);
+
+}  // namespace silo::query_engine::actions
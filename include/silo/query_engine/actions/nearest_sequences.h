@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json_fwd.hpp>
+
+#include "silo/query_engine/actions/action.h"
+#include "silo/query_engine/query_result.h"
+
+namespace silo {
+class Database;
+}  // namespace silo
+namespace silo::query_engine {
+class OperatorResult;
+}  // namespace silo::query_engine
+
+namespace silo::query_engine::actions {
+
+/// Finds the k filtered sequences with the smallest Hamming distance to a query sequence, which
+/// is either given as an aligned sequence or as mutations relative to the reference. Only
+/// positions where both the query and the stored sequence are not missing are compared. The
+/// distances are accumulated from the symbol bitmaps of the positions, without reconstructing
+/// the stored sequences.
+template <typename SymbolType>
+class NearestSequences : public Action {
+   std::optional<std::string> sequence_name;
+   std::optional<std::string> query_sequence;
+   std::vector<std::string> mutations;
+   uint32_t k;
+
+   const std::string DISTANCE_FIELD_NAME = "distance";
+   const std::string COMPARED_POSITIONS_FIELD_NAME = "comparedPositions";
+
+   [[nodiscard]] std::vector<std::optional<typename SymbolType::Symbol>> getQuerySymbols(
+      const std::vector<typename SymbolType::Symbol>& reference_sequence
+   ) const;
+
+   void validateOrderByFields(const Database& database) const override;
+
+   [[nodiscard]] QueryResult execute(
+      const Database& database,
+      std::vector<OperatorResult> bitmap_filter
+   ) const override;
+
+  public:
+   static constexpr uint32_t DEFAULT_K = 10;
+   static constexpr uint32_t K_LIMIT = 10'000;
+
+   NearestSequences(
+      std::optional<std::string> sequence_name,
+      std::optional<std::string> query_sequence,
+      std::vector<std::string>&& mutations,
+      uint32_t k
+   );
+};
+
+template <typename SymbolType>
+// NOLINTNEXTLINE(readability-identifier-naming)
+void from_json(const nlohmann::json& json, std::unique_ptr<NearestSequences<SymbolType>>& action);
+
+}  // namespace silo::query_engine::actions
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "silo/common/date.h"
+#include "silo/common/optional_bool.h"
+#include "silo/common/types.h"
+#include "silo/storage/column_group.h"
+
+namespace silo {
+class Database;
+}  // namespace silo
+
+namespace silo::query_engine::actions {
+
+struct OrderByField;
+
+/// Maps a double to an unsigned integer with the same order, as compared in Tuple: -0.0 equals 0.0
+/// and NaN (null) is the largest value
+uint64_t encodeDouble(double value);
+
+/// The values of the orderByFields of a row, packed into 128 bits such that comparing two keys
+/// compares the rows by their orderByFields, without decoding the fields by their column type
+struct NormalizedSortKey {
+   uint64_t high = 0;
+   uint64_t low = 0;
+
+   auto operator<=>(const NormalizedSortKey& other) const = default;
+};
+
+/// How the orderByFields are encoded into a NormalizedSortKey. Descending fields are encoded with
+/// inverted bits. Indexed string and pango lineage values are encoded by their rank among all
+/// values of the column in the database.
+class NormalizedSortKeyEncoding {
+   friend class NormalizedSortKeyFactory;
+
+   struct Field {
+      silo::storage::ColumnMetadata metadata;
+      bool ascending;
+      uint32_t bits;
+      /// The rank of every value id of an indexed string or pango lineage column
+      std::vector<uint32_t> value_ranks;
+   };
+
+   std::vector<Field> fields;
+
+  public:
+   static constexpr uint32_t MAX_BITS = 128;
+
+   /// Returns std::nullopt if one of the fields is a non-indexed string or an insertion column, or
+   /// if the fields do not fit into MAX_BITS
+   static std::optional<NormalizedSortKeyEncoding> create(
+      const Database& database,
+      const std::vector<OrderByField>& order_by_fields
+   );
+};
+
+/// Creates the NormalizedSortKeys of the rows of one partition, with the same interface as the
+/// TupleFactory
+class NormalizedSortKeyFactory {
+   struct FieldValues {
+      const NormalizedSortKeyEncoding::Field* field;
+      const silo::common::Date* dates = nullptr;
+      const int32_t* ints = nullptr;
+      const double* floats = nullptr;
+      const silo::common::OptionalBool* bools = nullptr;
+      const silo::Idx* value_ids = nullptr;
+   };
+
+   std::vector<FieldValues> field_values;
+
+  public:
+   NormalizedSortKeyFactory(
+      const NormalizedSortKeyEncoding& encoding,
+      const silo::storage::ColumnPartitionGroup& columns
+   );
+
+   [[nodiscard]] NormalizedSortKey allocateOne(uint32_t sequence_id) const;
+
+   NormalizedSortKey& overwrite(NormalizedSortKey& key, uint32_t sequence_id) const;
+
+   [[nodiscard]] std::vector<NormalizedSortKey> allocateMany(size_t count) const;
+};
+
+}  // namespace silo::query_engine::actions
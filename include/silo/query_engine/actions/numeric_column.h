@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "silo/common/date.h"
+#include "silo/common/json_value_type.h"
+#include "silo/storage/column_group.h"
+
+namespace silo {
+class Database;
+}  // namespace silo
+
+namespace silo::query_engine::actions {
+
+/// Read access to the values of an INT, FLOAT or DATE column partition as numbers. Dates are read
+/// as days since 1970-01-01, so that the width of a range of dates is its number of days.
+class NumericColumn {
+   const std::vector<int32_t>* int_values = nullptr;
+   const std::vector<double>* float_values = nullptr;
+   const std::vector<common::Date>* date_values = nullptr;
+
+  public:
+   NumericColumn(
+      const silo::storage::ColumnPartitionGroup& columns,
+      const silo::storage::ColumnMetadata& metadata
+   );
+
+   /// Returns std::nullopt for null values
+   [[nodiscard]] std::optional<double> getValue(uint32_t row) const;
+};
+
+/// The metadata of the field, which must be an INT, FLOAT or DATE field
+silo::storage::ColumnMetadata getNumericColumnMetadata(
+   const Database& database,
+   const std::string& field,
+   const std::string& action_name
+);
+
+/// Converts a number read by a NumericColumn back to a value of the column type
+common::JsonValueType numericValueToJson(double value, silo::config::ColumnType column_type);
+
+}  // namespace silo::query_engine::actions
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <roaring/roaring.hh>
+
+namespace silo {
+class Database;
+class DatabasePartition;
+}  // namespace silo
+
+namespace silo::query_engine::actions {
+
+/// A mutation given in a query as <reference symbol><position><symbol>, e.g. C241T. The reference
+/// symbol is optional.
+template <typename SymbolType>
+struct ParsedMutation {
+   uint32_t position_idx;
+   typename SymbolType::Symbol symbol;
+   /// The mutation including its reference symbol
+   std::string name;
+
+   static ParsedMutation<SymbolType> parse(
+      const std::string& mutation,
+      const std::vector<typename SymbolType::Symbol>& reference_sequence
+   );
+
+   /// The rows of the filter that have the symbol of the mutation in the sequence
+   [[nodiscard]] roaring::Roaring getRowsWithMutation(
+      const Database& database,
+      const DatabasePartition& database_partition,
+      const std::string& sequence_name,
+      const roaring::Roaring& filter
+   ) const;
+};
+
+}  // namespace silo::query_engine::actions
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json_fwd.hpp>
+
+#include "silo/query_engine/actions/action.h"
+#include "silo/query_engine/query_result.h"
+
+namespace silo {
+class Database;
+}  // namespace silo
+namespace silo::query_engine {
+class OperatorResult;
+}  // namespace silo::query_engine
+
+namespace silo::query_engine::actions {
+
+/// Exact quantiles of the non-null values of an INT, FLOAT or DATE field over the filtered rows,
+/// e.g. the median for the quantile 0.5. The quantile q is the value at rank ceil(q * n) of the
+/// n sorted values (nearest rank), so it is always one of the values.
+class Quantiles : public Action {
+   std::string field;
+   std::vector<double> quantiles;
+
+   const std::string QUANTILE_FIELD_NAME = "quantile";
+   const std::string VALUE_FIELD_NAME = "value";
+
+   void validateOrderByFields(const Database& database) const override;
+
+   [[nodiscard]] QueryResult execute(
+      const Database& database,
+      std::vector<OperatorResult> bitmap_filter
+   ) const override;
+
+  public:
+   Quantiles(std::string field, std::vector<double> quantiles);
+};
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void from_json(const nlohmann::json& json, std::unique_ptr<Quantiles>& action);
+
+}  // namespace silo::query_engine::actions
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "silo/query_engine/operator_result.h"
+
+namespace silo::query_engine::actions {
+
+/// Splits the rows that match the bitmap filters into chunks of rows of a single partition, in
+/// partition and row order. Skips the first `offset` rows and stops after `limit` rows.
+class RowChunks {
+   std::vector<OperatorResult> bitmap_filter;
+   size_t chunk_size;
+   size_t remaining_count;
+   size_t partition_id = 0;
+   /// The rank of the next row in the bitmap of the current partition
+   size_t rank_in_partition;
+
+  public:
+   struct Chunk {
+      size_t partition_id;
+      std::vector<uint32_t> row_ids;
+   };
+
+   RowChunks(
+      std::vector<OperatorResult> bitmap_filter,
+      size_t offset,
+      std::optional<size_t> limit,
+      size_t chunk_size
+   );
+
+   /// The number of rows in all chunks that are not produced yet
+   [[nodiscard]] size_t remainingCount() const;
+
+   /// Returns std::nullopt once all rows were produced
+   std::optional<Chunk> next();
+};
+
+}  // namespace silo::query_engine::actions
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "silo/common/symbol_map.h"
+
+namespace silo {
+class Database;
+template <typename SymbolType>
+class SequenceStore;
+template <typename SymbolType>
+class SequenceStorePartition;
+}  // namespace silo
+namespace silo::query_engine {
+class OperatorResult;
+}  // namespace silo::query_engine
+
+namespace silo::query_engine::actions {
+
+/// The filters of the partitions together with the sequence store partitions that they select
+/// from. Filters that contain all rows of their partition are kept apart, because their symbols
+/// are counted from the cardinalities of the position bitmaps alone.
+template <typename SymbolType>
+struct PrefilteredBitmaps {
+   std::vector<std::pair<const OperatorResult&, const silo::SequenceStorePartition<SymbolType>&>>
+      bitmaps;
+   std::vector<std::pair<const OperatorResult&, const silo::SequenceStorePartition<SymbolType>&>>
+      full_bitmaps;
+};
+
+/// The non-empty filters of the partitions per sequence name
+template <typename SymbolType>
+std::unordered_map<std::string, PrefilteredBitmaps<SymbolType>> preFilterBitmaps(
+   const silo::Database& database,
+   std::vector<OperatorResult>& bitmap_filter
+);
+
+/// The number of filtered sequences with each symbol at each position of the sequence
+template <typename SymbolType>
+SymbolMap<SymbolType, std::vector<uint32_t>> calculateMutationsPerPosition(
+   const SequenceStore<SymbolType>& sequence_store,
+   const PrefilteredBitmaps<SymbolType>& bitmap_filter
+);
+
+}  // namespace silo::query_engine::actions
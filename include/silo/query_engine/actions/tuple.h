@@ -21,6 +21,8 @@ size_t getTupleSize(const std::vector<silo::storage::ColumnMetadata>& metadata_l
 
 class Tuple {
    friend class TupleFactory;
+   template <typename Value>
+   friend class TupleMap;
 
    struct ComparatorField {
       size_t offset;
@@ -77,6 +79,9 @@ struct std::hash<silo::query_engine::actions::Tuple> {
 namespace silo::query_engine::actions {
 
 class TupleFactory {
+   template <typename Value>
+   friend class TupleMap;
+
    std::deque<std::vector<std::byte>> all_tuple_data;
    silo::storage::ColumnPartitionGroup columns;
    size_t tuple_size;
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "silo/query_engine/actions/tuple.h"
+#include "silo/storage/column_group.h"
+
+namespace silo::query_engine::actions {
+
+/// Open-addressing hash map from Tuples to values. The fixed-width tuple data is stored inline in
+/// one contiguous buffer next to its precomputed hash, instead of pointing into a TupleFactory.
+/// The map is radix-partitioned by the upper bits of the hash, so that the maps built for
+/// different database partitions can be merged in parallel, one radix partition per task.
+/// Values are merged with `operator+=`.
+template <typename Value>
+class TupleMap {
+  public:
+   static constexpr uint32_t RADIX_BITS = 6;
+   static constexpr uint32_t RADIX_PARTITION_COUNT = 1U << RADIX_BITS;
+
+  private:
+   /// Linear probing table. A stored hash of 0 marks an empty slot.
+   struct Table {
+      std::vector<uint64_t> hashes;
+      std::vector<Value> values;
+      std::vector<std::byte> keys;
+      size_t size = 0;
+   };
+
+   const silo::storage::ColumnPartitionGroup* columns;
+   size_t tuple_size;
+   std::array<Table, RADIX_PARTITION_COUNT> tables;
+
+   [[nodiscard]] uint64_t hash(const std::byte* key) const;
+
+   Value& findOrInsert(Table& table, const std::byte* key, uint64_t key_hash);
+
+   void grow(Table& table);
+
+  public:
+   /// Keys are decoded with the columns of the factory, which must outlive the map
+   explicit TupleMap(const TupleFactory& tuple_factory);
+
+   /// Returns the value of the tuple, default-constructing it if the tuple is new. The reference
+   /// is invalidated by the next insertion.
+   Value& operator[](const Tuple& tuple);
+
+   [[nodiscard]] size_t size() const;
+
+   /// Merges the maps in parallel over the radix partitions. All maps must have been created for
+   /// the same group-by fields. The merged maps are consumed.
+   static TupleMap merge(const TupleFactory& tuple_factory, std::vector<TupleMap>& maps);
+
+   /// Calls the function for every entry of the radix partition. The Tuple is only a view on the
+   /// map's data and valid during the call.
+   void forEachInRadixPartition(
+      uint32_t radix_partition,
+      const std::function<void(const Tuple&, Value&)>& function
+   );
+};
+
+using TupleCountMap = TupleMap<uint32_t>;
+
+}  // namespace silo::query_engine::actions
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <optional>
 #include <string>
@@ -19,6 +21,18 @@ struct QueryResultEntry {
 
 struct QueryResult {
    std::vector<QueryResultEntry> query_result;
+   /// Set by actions that support pagination if there may be further results
+   std::optional<std::string> continuation_token;
+   /// Set by actions that stream their results. Every call produces the next chunk of entries,
+   /// which follow the entries in query_result. An empty chunk ends the stream.
+   std::function<std::vector<QueryResultEntry>()> next_chunk;
+   /// The number of entries that the chunks of a streamed result contain in total
+   size_t streamed_entry_count = 0;
+
+   [[nodiscard]] bool isStreamed() const;
+
+   /// Appends all remaining chunks of a streamed result to query_result
+   void materialize();
 };
 
 // NOLINTBEGIN(readability-identifier-naming)
@@ -48,6 +48,8 @@ class IndexedStringColumnPartition {
 
    [[nodiscard]] const std::vector<silo::Idx>& getValues() const;
 
+   [[nodiscard]] const std::unordered_map<Idx, roaring::Roaring>& getValueBitmaps() const;
+
    [[nodiscard]] inline std::string lookupValue(Idx id) const { return lookup.getValue(id); }
 };
 
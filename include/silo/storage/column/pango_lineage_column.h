@@ -65,6 +65,8 @@ class PangoLineageColumnPartition {
 
    const std::vector<silo::Idx>& getValues() const;
 
+   const std::unordered_map<Idx, roaring::Roaring>& getValueBitmaps() const;
+
    common::AliasedPangoLineage lookupAliasedValue(Idx idx) const;
    common::UnaliasedPangoLineage lookupUnaliasedValue(Idx idx) const;
 };
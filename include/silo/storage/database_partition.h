@@ -7,6 +7,7 @@
 
 #include "silo/preprocessing/partition.h"
 #include "silo/storage/column_group.h"
+#include "silo/storage/row_sample.h"
 
 namespace boost {
 namespace serialization {
@@ -70,6 +71,8 @@ class DatabasePartition {
    std::map<std::string, UnalignedSequenceStorePartition&> unaligned_nuc_sequences;
    std::map<std::string, SequenceStorePartition<AminoAcid>&> aa_sequences;
    uint32_t sequence_count = 0;
+   /// Not serialized, it is rebuilt from the sequence_count after building or loading
+   storage::RowSample row_sample;
 
   private:
    DatabasePartition() = default;
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <roaring/roaring.hh>
+
+namespace silo::storage {
+
+/// Nested deterministic samples of the rows of a partition, so that approximate queries can
+/// sample their filter with a single intersection. A row belongs to the levels 1 to k, if the k
+/// highest bits of the hash of its partition and row id are zero. Therefore, level k contains
+/// about a 2^-k share of the rows and every level contains all deeper levels.
+class RowSample {
+   /// levels[k - 1] contains the rows of level k
+   std::vector<roaring::Roaring> levels;
+
+  public:
+   RowSample() = default;
+
+   RowSample(uint32_t partition_id, uint32_t row_count);
+
+   /// The rows of the given level, which must be at least 1. Levels deeper than the deepest
+   /// non-empty level are empty.
+   [[nodiscard]] const roaring::Roaring& getLevel(uint32_t level) const;
+};
+
+}  // namespace silo::storage
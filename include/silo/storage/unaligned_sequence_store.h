@@ -1,9 +1,16 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <deque>
 #include <filesystem>
+#include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
+
+#include "silo/common/json_value_type.h"
 
 namespace boost::serialization {
 class access;
@@ -12,20 +19,49 @@ class access;
 namespace silo {
 class ZstdFastaTableReader;
 
+/// The primary key as it is written to the key column of the unaligned sequence files
+std::string primaryKeyToString(const common::JsonValueType::value_type& primary_key);
+
 class UnalignedSequenceStorePartition {
    friend class boost::serialization::access;
 
+   class MappedFile;
+
    std::string sql_for_reading_file;
+   std::filesystem::path offsets_file;
+   std::filesystem::path sequences_file;
+   /// The start of the compressed sequence of every row in the sequences file, followed by the
+   /// end of the last one. Null sequences have an empty range.
+   std::vector<uint64_t> offsets;
+   std::shared_ptr<const MappedFile> mapped_sequences;
+
+   void loadRowIndex();
 
   public:
    const std::string& compression_dictionary;
 
    explicit UnalignedSequenceStorePartition(
       std::string sql_for_reading_file,
+      std::filesystem::path file_prefix,
       const std::string& compression_dictionary
    );
 
    std::string getReadSQL() const;
+
+   /// Writes the compressed sequences in row order to the offsets and sequences files of this
+   /// partition and maps them for reading
+   void fill(const std::vector<std::optional<std::string>>& compressed_sequences);
+
+   /// Writes the compressed sequences of the input to the offsets and sequences files while they
+   /// are read. The input must yield one entry for every row of the partition, in row order.
+   /// Returns the number of rows read.
+   size_t fill(ZstdFastaTableReader& input);
+
+   /// Whether the sequences can be read by row id, without going through the parquet files
+   [[nodiscard]] bool hasRowIndex() const;
+
+   /// Returns the zstd-compressed sequence of the row, or std::nullopt if it is null
+   [[nodiscard]] std::optional<std::string_view> getCompressedSequence(uint32_t row_id) const;
 };
 
 class UnalignedSequenceStore {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -58,9 +59,15 @@ namespace silo::test {
                                                                                                    \
    TEST_P(TEST_SUITE_NAME##FixtureAlias, testQuery) {                                              \
       const auto scenario = GetParam();                                                            \
-      const auto result = query_engine.executeQuery(nlohmann::to_string(scenario.query));          \
-      const auto actual = nlohmann::json(result.query_result);                                     \
-      ASSERT_EQ(actual, scenario.expected_query_result);                                           \
+      auto result = query_engine.executeQuery(nlohmann::to_string(scenario.query));                \
+      result.materialize();                                                                        \
+      auto actual = nlohmann::json(result.query_result);                                           \
+      auto expected = scenario.expected_query_result;                                              \
+      if (scenario.ignore_order) {                                                                 \
+         std::sort(actual.begin(), actual.end());                                                  \
+         std::sort(expected.begin(), expected.end());                                              \
+      }                                                                                            \
+      ASSERT_EQ(actual, expected);                                                                 \
    }                                                                                               \
    }  // namespace
 
@@ -75,6 +82,8 @@ struct QueryTestScenario {
    std::string name;
    nlohmann::json query;
    nlohmann::json expected_query_result;
+   /// Compares the results as multisets, for queries whose result order is unspecified
+   bool ignore_order = false;
 };
 
 std::string printScenarioName(const ::testing::TestParamInfo<QueryTestScenario>& scenario);
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 #include <Poco/Net/HTTPServerRequest.h>
 #include <Poco/Net/HTTPServerResponse.h>
 
@@ -13,9 +15,10 @@ namespace silo_api {
 class QueryHandler : public RestResource {
   private:
    silo_api::DatabaseMutex& database_mutex;
+   uint32_t max_streamed_sequences;
 
   public:
-   explicit QueryHandler(silo_api::DatabaseMutex& database);
+   QueryHandler(silo_api::DatabaseMutex& database, uint32_t max_streamed_sequences);
 
    void post(Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response)
       override;
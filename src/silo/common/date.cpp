@@ -1,3 +1,4 @@
+#include <chrono>
 #include <iomanip>
 #include <optional>
 #include <sstream>
@@ -14,6 +15,11 @@ constexpr uint32_t NUMBER_OF_MONTHS = 12;
 constexpr uint32_t NUMBER_OF_DAYS = 31;
 constexpr uint32_t BYTES_FOR_MONTHS = 4;
 constexpr uint32_t BYTES_FOR_DAYS = 12;
+constexpr uint32_t MONTHS_PER_QUARTER = 3;
+
+silo::common::Date toDate(uint32_t year, uint32_t month, uint32_t day) {
+   return (year << (BYTES_FOR_MONTHS + BYTES_FOR_DAYS)) + (month << BYTES_FOR_DAYS) + day;
+}
 
 }  // namespace
 
@@ -78,3 +84,60 @@ std::optional<std::string> silo::common::dateToString(silo::common::Date date) {
 
    return result_string.str();
 }
+
+silo::common::Date silo::common::truncateDate(
+   silo::common::Date date,
+   DateTruncation truncation
+) {
+   if (date == NULL_DATE) {
+      return NULL_DATE;
+   }
+   const uint32_t year = date >> (BYTES_FOR_MONTHS + BYTES_FOR_DAYS);
+   const uint32_t month = (date >> BYTES_FOR_DAYS) & 0xF;
+   switch (truncation) {
+      case DateTruncation::DAY:
+         return date;
+      case DateTruncation::WEEK: {
+         // Days beyond the end of the month, e.g. 2021-02-30, count into the next month
+         const std::chrono::sys_days days = std::chrono::year_month_day{
+            std::chrono::year{static_cast<int>(year)},
+            std::chrono::month{month},
+            std::chrono::day{date & 0xFFF}
+         };
+         const std::chrono::year_month_day monday{
+            days - (std::chrono::weekday{days} - std::chrono::Monday)
+         };
+         return toDate(
+            static_cast<uint32_t>(static_cast<int>(monday.year())),
+            static_cast<uint32_t>(monday.month()),
+            static_cast<uint32_t>(monday.day())
+         );
+      }
+      case DateTruncation::MONTH:
+         return toDate(year, month, 1);
+      case DateTruncation::QUARTER:
+         return toDate(year, month - ((month - 1) % MONTHS_PER_QUARTER), 1);
+      case DateTruncation::YEAR:
+         return toDate(year, 1, 1);
+   }
+   throw std::runtime_error("Non-exhausting date truncations should be covered by linter");
+}
+
+int32_t silo::common::dateToDays(silo::common::Date date) {
+   // Days beyond the end of the month, e.g. 2021-02-30, count into the next month
+   const std::chrono::sys_days days = std::chrono::year_month_day{
+      std::chrono::year{static_cast<int>(date >> (BYTES_FOR_MONTHS + BYTES_FOR_DAYS))},
+      std::chrono::month{(date >> BYTES_FOR_DAYS) & 0xF},
+      std::chrono::day{date & 0xFFF}
+   };
+   return days.time_since_epoch().count();
+}
+
+silo::common::Date silo::common::daysToDate(int32_t days) {
+   const std::chrono::year_month_day date{std::chrono::sys_days{std::chrono::days{days}}};
+   return toDate(
+      static_cast<uint32_t>(static_cast<int>(date.year())),
+      static_cast<uint32_t>(date.month()),
+      static_cast<uint32_t>(date.day())
+   );
+}
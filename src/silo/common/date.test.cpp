@@ -30,3 +30,38 @@ TEST(Date, correctlyReprintsStrings) {
 
    EXPECT_EQ(silo::common::dateToString(silo::common::stringToDate("")), std::nullopt);
 }
+
+TEST(Date, truncatesDates) {
+   using silo::common::DateTruncation;
+   using silo::common::stringToDate;
+   using silo::common::truncateDate;
+
+   const auto date = stringToDate("2021-08-19");
+   EXPECT_EQ(truncateDate(date, DateTruncation::DAY), date);
+   EXPECT_EQ(truncateDate(date, DateTruncation::WEEK), stringToDate("2021-08-16"));
+   EXPECT_EQ(truncateDate(date, DateTruncation::MONTH), stringToDate("2021-08-01"));
+   EXPECT_EQ(truncateDate(date, DateTruncation::QUARTER), stringToDate("2021-07-01"));
+   EXPECT_EQ(truncateDate(date, DateTruncation::YEAR), stringToDate("2021-01-01"));
+
+   EXPECT_EQ(
+      truncateDate(stringToDate("2021-01-02"), DateTruncation::WEEK), stringToDate("2020-12-28")
+   );
+   EXPECT_EQ(
+      truncateDate(stringToDate("2021-03-01"), DateTruncation::WEEK), stringToDate("2021-03-01")
+   );
+   EXPECT_EQ(
+      truncateDate(stringToDate("2021-12-31"), DateTruncation::QUARTER), stringToDate("2021-10-01")
+   );
+   EXPECT_EQ(truncateDate(silo::common::NULL_DATE, DateTruncation::MONTH), silo::common::NULL_DATE);
+}
+
+TEST(Date, convertsDatesToDaysAndBack) {
+   using silo::common::dateToDays;
+   using silo::common::daysToDate;
+   using silo::common::stringToDate;
+
+   EXPECT_EQ(dateToDays(stringToDate("1970-01-01")), 0);
+   EXPECT_EQ(dateToDays(stringToDate("1969-12-31")), -1);
+   EXPECT_EQ(dateToDays(stringToDate("2021-03-01")) - dateToDays(stringToDate("2021-02-28")), 1);
+   EXPECT_EQ(daysToDate(dateToDays(stringToDate("2024-02-29")) + 1), stringToDate("2024-03-01"));
+}
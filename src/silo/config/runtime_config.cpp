@@ -50,6 +50,14 @@ void RuntimeConfig::overwrite(const silo::config::AbstractConfig& config) {
          std::chrono::minutes(config.getInt32(ESTIMATED_STARTUP_TIME_IN_MINUTES_OPTION));
       estimated_startup_end = std::chrono::system_clock::now() + minutes;
    }
+   if (config.hasProperty(MAX_STREAMED_SEQUENCES_OPTION)) {
+      SPDLOG_DEBUG(
+         "Using maximum number of streamed sequences as passed via {}: {}",
+         config.configType(),
+         config.getString(MAX_STREAMED_SEQUENCES_OPTION)
+      );
+      max_streamed_sequences = config.getUInt32(MAX_STREAMED_SEQUENCES_OPTION);
+   }
 }
 
 }  // namespace silo_api
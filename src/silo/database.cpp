@@ -9,6 +9,7 @@
 #include <fstream>
 #include <functional>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <stdexcept>
@@ -61,6 +62,7 @@
 #include "silo/storage/database_partition.h"
 #include "silo/storage/pango_lineage_alias.h"
 #include "silo/storage/reference_genomes.h"
+#include "silo/storage/row_sample.h"
 #include "silo/storage/sequence_store.h"
 #include "silo/storage/serialize_optional.h"
 #include "silo/storage/unaligned_sequence_store.h"
@@ -568,6 +570,8 @@ Database Database::loadDatabaseState(const std::filesystem::path& save_directory
    );
    SPDLOG_INFO("Finished loading partition data");
 
+   database.buildRowSamples();
+
    database.setDataVersion(loadDataVersion(save_directory / "data_version.silo"));
    SPDLOG_INFO(
       "Finished loading data_version from {}", (save_directory / "data_version.silo").string()
@@ -679,6 +683,12 @@ void Database::initializeNucSequences(
       }
    }
    SPDLOG_TRACE("initializing unaligned nucleotide sequences");
+   unaligned_sequences_duckdb = std::make_shared<duckdb::DuckDB>(nullptr);
+   {
+      duckdb::Connection connection(*unaligned_sequences_duckdb);
+      // Keep the parquet metadata of the sequence files cached between Fasta queries
+      connection.Query("SET enable_object_cache = true;");
+   }
    for (const auto& [nuc_name, reference_sequence] : reference_sequences) {
       const std::filesystem::path sequence_directory =
          intermediate_results_directory / ("unaligned_nuc_" + nuc_name);
@@ -726,6 +736,16 @@ void Database::finalizeInsertionIndexes() {
    });
 }
 
+void Database::buildRowSamples() {
+   tbb::parallel_for(tbb::blocked_range<size_t>(0, partitions.size()), [&](const auto& local) {
+      for (size_t partition_id = local.begin(); partition_id != local.end(); ++partition_id) {
+         auto& partition = partitions[partition_id];
+         partition.row_sample =
+            storage::RowSample(static_cast<uint32_t>(partition_id), partition.sequence_count);
+      }
+   });
+}
+
 void Database::setDataVersion(const DataVersion& data_version) {
    SPDLOG_DEBUG("Set data version to {}", data_version.toString());
    data_version_ = data_version;
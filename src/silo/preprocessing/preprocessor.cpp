@@ -1,5 +1,8 @@
 #include "silo/preprocessing/preprocessor.h"
 
+#include <string>
+#include <utility>
+
 #include <oneapi/tbb/blocked_range.h>
 #include <oneapi/tbb/parallel_for.h>
 #include <silo/zstdfasta/zstdfasta_table_reader.h>
@@ -495,8 +498,15 @@ Database Preprocessor::buildDatabase(
 
       tasks.wait();
 
+      SPDLOG_INFO("build - building unaligned nucleotide sequence stores");
+      buildUnalignedSequenceStore(database, order_by_clause);
+      SPDLOG_INFO("build - finished unaligned nucleotide sequence stores");
+
       SPDLOG_INFO("build - finalizing insertion indexes");
       database.finalizeInsertionIndexes();
+
+      SPDLOG_INFO("build - building row samples");
+      database.buildRowSamples();
    }
 
    SPDLOG_INFO("Build took {}", silo::common::formatDuration(micros));
@@ -569,6 +579,66 @@ void Preprocessor::buildNucleotideSequenceStore(
    }
 }
 
+void Preprocessor::buildUnalignedSequenceStore(
+   Database& database,
+   const std::string& order_by_clause
+) {
+   const std::string& primary_key = database_config.schema.primary_key;
+   for (const auto& [nuc_name, _] : reference_genomes_.raw_nucleotide_sequences) {
+      tbb::parallel_for(
+         tbb::blocked_range<size_t>(0, database.partitions.size()),
+         [&](const auto& local) {
+            for (auto partition_index = local.begin(); partition_index != local.end();
+                 ++partition_index) {
+               SPDLOG_DEBUG(
+                  "build - building unaligned sequence store for nucleotide sequence {} and "
+                  "partition {}",
+                  nuc_name,
+                  partition_index
+               );
+               auto& partition = database.partitions.at(partition_index);
+               auto& sequence_store = partition.unaligned_nuc_sequences.at(nuc_name);
+
+               // The sequences are joined to the rows of the partition, numbered in the order of
+               // the metadata, such that they are written to the row index while they are read
+               const std::string sequences_in_row_order = fmt::format(
+                  "(SELECT CAST(metadata.row_key AS VARCHAR) AS key, "
+                  "unaligned.unaligned_nuc_{0} AS unaligned_nuc_{0}, metadata.row_id AS row_id "
+                  "FROM (SELECT \"{1}\" AS row_key, row_number() OVER ({2}) AS row_id "
+                  "FROM partitioned_metadata WHERE partition_id = {3}) AS metadata "
+                  "LEFT JOIN ({4}) AS unaligned ON unaligned.key = metadata.row_key)",
+                  nuc_name,
+                  primary_key,
+                  order_by_clause,
+                  partition_index,
+                  sequence_store.getReadSQL()
+               );
+               silo::ZstdFastaTableReader sequence_input(
+                  preprocessing_db.getConnection(),
+                  sequences_in_row_order,
+                  sequence_store.compression_dictionary,
+                  "unaligned_nuc_" + nuc_name,
+                  "TRUE",
+                  "ORDER BY row_id"
+               );
+               const size_t sequences_added = sequence_store.fill(sequence_input);
+               if (sequences_added != partition.sequence_count) {
+                  throw silo::preprocessing::PreprocessingException(fmt::format(
+                     "The unaligned nucleotide sequence {} has {} rows in partition {}, but the "
+                     "metadata has {}",
+                     nuc_name,
+                     sequences_added,
+                     partition_index,
+                     partition.sequence_count
+                  ));
+               }
+            }
+         }
+      );
+      SPDLOG_INFO("build - finished unaligned nucleotide sequence {}", nuc_name);
+   }
+}
+
 void Preprocessor::buildAminoAcidSequenceStore(
    silo::Database& database,
    const preprocessing::Partitions& partition_descriptor,
@@ -131,7 +131,8 @@ TEST_P(PreprocessorTestFixture, shouldProcessDataSetWithMissingSequences) {
    EXPECT_EQ(database_info.sequence_count, scenario.expected_sequence_count);
 
    const silo::query_engine::QueryEngine query_engine(database);
-   const auto result = query_engine.executeQuery(scenario.query);
+   auto result = query_engine.executeQuery(scenario.query);
+   result.materialize();
 
    const auto actual = nlohmann::json(result.query_result);
    ASSERT_EQ(actual, scenario.expected_query_result);
@@ -3,19 +3,31 @@
 #include <algorithm>
 #include <cctype>
 #include <chrono>
+#include <compare>
 #include <map>
 #include <memory>
+#include <numeric>
 #include <random>
 #include <utility>
+#include <variant>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
 #include "silo/query_engine/actions/aggregated.h"
 #include "silo/query_engine/actions/details.h"
+#include "silo/query_engine/actions/diversity.h"
+#include "silo/query_engine/actions/facets.h"
 #include "silo/query_engine/actions/fasta.h"
 #include "silo/query_engine/actions/fasta_aligned.h"
+#include "silo/query_engine/actions/histogram.h"
 #include "silo/query_engine/actions/insertions.h"
+#include "silo/query_engine/actions/mutation_cooccurrence.h"
 #include "silo/query_engine/actions/mutations.h"
+#include "silo/query_engine/actions/mutations_over_time.h"
+#include "silo/query_engine/actions/nearest_sequences.h"
+#include "silo/query_engine/actions/normalized_sort_key.h"
+#include "silo/query_engine/actions/quantiles.h"
 #include "silo/query_engine/operator_result.h"
 #include "silo/query_engine/query_parse_exception.h"
 #include "silo/query_engine/query_result.h"
@@ -36,19 +48,95 @@ std::string stringToLowerCase(std::string str) {
    return str;
 }
 
-void Action::applySort(QueryResult& result) const {
-   auto& result_vector = result.query_result;
+namespace {
+
+/// The values of one orderByField of all result entries, extracted once before sorting. Fields
+/// whose values all have the same type (or are null) are stored as contiguous integer codes or
+/// string pointers, other fields keep pointers to their values.
+class SortKeyColumn {
+   enum class Kind { CODES, STRINGS, VALUES };
+
+   Kind kind = Kind::CODES;
+   bool ascending;
+   /// Order preserving codes with the direction of the field applied, null values are 0
+   std::vector<uint64_t> codes;
+   /// nullptr for null values
+   std::vector<const std::string*> strings;
+   std::vector<const common::JsonValueType*> values;
+
+   static uint64_t encode(const std::variant<std::string, bool, int32_t, double>& value) {
+      if (const auto* bool_value = std::get_if<bool>(&value)) {
+         return *bool_value ? 2 : 1;
+      }
+      if (const auto* int_value = std::get_if<int32_t>(&value)) {
+         return static_cast<uint64_t>(static_cast<uint32_t>(*int_value) ^ (1U << 31)) + 1;
+      }
+      return encodeDouble(std::get<double>(value));
+   }
 
-   auto cmp = [&](const QueryResultEntry& entry1, const QueryResultEntry& entry2) {
-      for (const OrderByField& field : order_by_fields) {
-         if (entry1.fields.at(field.name) == entry2.fields.at(field.name)) {
+  public:
+   SortKeyColumn(const std::vector<QueryResultEntry>& entries, const OrderByField& field)
+       : ascending(field.ascending) {
+      values.reserve(entries.size());
+      std::optional<size_t> value_type;
+      for (const QueryResultEntry& entry : entries) {
+         const common::JsonValueType& value = entry.fields.at(field.name);
+         values.push_back(&value);
+         if (!value.has_value()) {
             continue;
          }
-         return entry1.fields.at(field.name) < entry2.fields.at(field.name) ? field.ascending
-                                                                            : !field.ascending;
+         if (value_type.has_value() && value_type != value->index()) {
+            kind = Kind::VALUES;
+         }
+         value_type = value->index();
       }
-      return false;
-   };
+      if (kind == Kind::VALUES) {
+         return;
+      }
+      if (value_type == 0) {
+         kind = Kind::STRINGS;
+         strings.reserve(values.size());
+         for (const common::JsonValueType* value : values) {
+            strings.push_back(
+               value->has_value() ? &std::get<std::string>(value->value()) : nullptr
+            );
+         }
+      } else {
+         codes.reserve(values.size());
+         for (const common::JsonValueType* value : values) {
+            const uint64_t code = value->has_value() ? encode(value->value()) : 0;
+            codes.push_back(ascending ? code : ~code);
+         }
+      }
+      values = {};
+   }
+
+   [[nodiscard]] std::strong_ordering compare(uint32_t left, uint32_t right) const {
+      if (kind == Kind::CODES) {
+         return codes[left] <=> codes[right];
+      }
+      std::strong_ordering order = std::strong_ordering::equal;
+      if (kind == Kind::STRINGS) {
+         const std::string* left_value = strings[left];
+         const std::string* right_value = strings[right];
+         if (left_value == nullptr || right_value == nullptr) {
+            order = (left_value != nullptr) <=> (right_value != nullptr);
+         } else {
+            order = *left_value <=> *right_value;
+         }
+      } else if (*values[left] != *values[right]) {
+         order = *values[left] < *values[right] ? std::strong_ordering::less
+                                                : std::strong_ordering::greater;
+      }
+      return ascending ? order : 0 <=> order;
+   }
+};
+
+}  // namespace
+
+void Action::applySort(QueryResult& result) const {
+   auto& result_vector = result.query_result;
+
    const size_t end_of_sort = std::min(
       static_cast<size_t>(limit.value_or(result_vector.size()) + offset.value_or(0UL)),
       result_vector.size()
@@ -59,18 +147,45 @@ void Action::applySort(QueryResult& result) const {
          result_vector.begin(), result_vector.begin() + static_cast<int64_t>(end_of_sort), rng
       );
    }
-   if (!order_by_fields.empty()) {
-      if (end_of_sort < result_vector.size()) {
-         std::partial_sort(
-            result_vector.begin(),
-            result_vector.begin() + static_cast<int64_t>(end_of_sort),
-            result_vector.end(),
-            cmp
-         );
-      } else {
-         std::sort(result_vector.begin(), result_vector.end(), cmp);
+   if (order_by_fields.empty()) {
+      return;
+   }
+
+   std::vector<SortKeyColumn> sort_key_columns;
+   sort_key_columns.reserve(order_by_fields.size());
+   for (const OrderByField& field : order_by_fields) {
+      sort_key_columns.emplace_back(result_vector, field);
+   }
+   // Ties are broken by the position in the result, which makes the sort stable
+   auto comes_before = [&](uint32_t left, uint32_t right) {
+      for (const SortKeyColumn& column : sort_key_columns) {
+         const std::strong_ordering order = column.compare(left, right);
+         if (order != std::strong_ordering::equal) {
+            return order == std::strong_ordering::less;
+         }
       }
+      return left < right;
+   };
+   std::vector<uint32_t> permutation(result_vector.size());
+   std::iota(permutation.begin(), permutation.end(), 0);
+   if (end_of_sort < result_vector.size()) {
+      std::partial_sort(
+         permutation.begin(),
+         permutation.begin() + static_cast<int64_t>(end_of_sort),
+         permutation.end(),
+         comes_before
+      );
+   } else {
+      std::sort(permutation.begin(), permutation.end(), comes_before);
+   }
+   sort_key_columns.clear();
+
+   std::vector<QueryResultEntry> sorted_entries;
+   sorted_entries.reserve(result_vector.size());
+   for (const uint32_t index : permutation) {
+      sorted_entries.push_back(std::move(result_vector[index]));
    }
+   result_vector = std::move(sorted_entries);
 }
 
 void Action::applyOffsetAndLimit(QueryResult& result) const {
@@ -111,6 +226,10 @@ void Action::setOrdering(
    randomize_seed = randomize_seed_;
 }
 
+void Action::setFilterExpression(std::string filter_expression_) {
+   filter_expression = std::move(filter_expression_);
+}
+
 QueryResult Action::executeAndOrder(
    const Database& database,
    std::vector<OperatorResult> bitmap_filter
@@ -205,6 +324,8 @@ void from_json(const nlohmann::json& json, std::unique_ptr<Action>& action) {
       action = json.get<std::unique_ptr<Details>>();
    } else if (expression_type == "AminoAcidMutations") {
       action = json.get<std::unique_ptr<Mutations<AminoAcid>>>();
+   } else if (expression_type == "Facets") {
+      action = json.get<std::unique_ptr<Facets>>();
    } else if (expression_type == "Fasta") {
       action = json.get<std::unique_ptr<Fasta>>();
    } else if (expression_type == "FastaAligned") {
@@ -213,6 +334,26 @@ void from_json(const nlohmann::json& json, std::unique_ptr<Action>& action) {
       action = json.get<std::unique_ptr<InsertionAggregation<Nucleotide>>>();
    } else if (expression_type == "AminoAcidInsertions") {
       action = json.get<std::unique_ptr<InsertionAggregation<AminoAcid>>>();
+   } else if (expression_type == "MutationCooccurrence") {
+      action = json.get<std::unique_ptr<MutationCooccurrence<Nucleotide>>>();
+   } else if (expression_type == "AminoAcidMutationCooccurrence") {
+      action = json.get<std::unique_ptr<MutationCooccurrence<AminoAcid>>>();
+   } else if (expression_type == "MutationsOverTime") {
+      action = json.get<std::unique_ptr<MutationsOverTime<Nucleotide>>>();
+   } else if (expression_type == "AminoAcidMutationsOverTime") {
+      action = json.get<std::unique_ptr<MutationsOverTime<AminoAcid>>>();
+   } else if (expression_type == "Histogram") {
+      action = json.get<std::unique_ptr<Histogram>>();
+   } else if (expression_type == "Quantiles") {
+      action = json.get<std::unique_ptr<Quantiles>>();
+   } else if (expression_type == "Diversity") {
+      action = json.get<std::unique_ptr<Diversity<Nucleotide>>>();
+   } else if (expression_type == "AminoAcidDiversity") {
+      action = json.get<std::unique_ptr<Diversity<AminoAcid>>>();
+   } else if (expression_type == "NearestSequences") {
+      action = json.get<std::unique_ptr<NearestSequences<Nucleotide>>>();
+   } else if (expression_type == "AminoAcidNearestSequences") {
+      action = json.get<std::unique_ptr<NearestSequences<AminoAcid>>>();
    } else {
       throw QueryParseException(expression_type + " is not a valid action");
    }
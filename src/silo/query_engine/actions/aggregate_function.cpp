@@ -0,0 +1,290 @@
+#include "silo/query_engine/actions/aggregate_function.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <variant>
+
+#include <nlohmann/json.hpp>
+
+#include "silo/common/date.h"
+#include "silo/config/database_config.h"
+#include "silo/database.h"
+#include "silo/query_engine/query_parse_exception.h"
+
+namespace silo::query_engine::actions {
+
+namespace {
+
+using silo::config::ColumnType;
+
+const std::map<std::string, AggregateFunctionType> AGGREGATE_FUNCTION_NAMES{
+   {"sum", AggregateFunctionType::SUM},
+   {"min", AggregateFunctionType::MIN},
+   {"max", AggregateFunctionType::MAX},
+   {"mean", AggregateFunctionType::MEAN},
+   {"countDistinct", AggregateFunctionType::COUNT_DISTINCT},
+};
+
+std::string functionName(AggregateFunctionType type) {
+   for (const auto& [name, function_type] : AGGREGATE_FUNCTION_NAMES) {
+      if (function_type == type) {
+         return name;
+      }
+   }
+   throw std::runtime_error("Non-exhausting function names should be covered by linter");
+}
+
+/// Returns the value of the row as double, which represents INT and DATE values exactly
+std::optional<double> readValue(
+   const silo::storage::ColumnPartitionGroup& columns,
+   const silo::storage::ColumnMetadata& metadata,
+   uint32_t row
+) {
+   if (metadata.type == ColumnType::INT) {
+      const int32_t value = columns.int_columns.at(metadata.name).getValues()[row];
+      if (value == INT32_MIN) {
+         return std::nullopt;
+      }
+      return value;
+   }
+   if (metadata.type == ColumnType::FLOAT) {
+      const double value = columns.float_columns.at(metadata.name).getValues()[row];
+      if (std::isnan(value)) {
+         return std::nullopt;
+      }
+      return value;
+   }
+   const silo::common::Date value = columns.date_columns.at(metadata.name).getValues()[row];
+   if (value == silo::common::NULL_DATE) {
+      return std::nullopt;
+   }
+   return value;
+}
+
+common::JsonValueType toColumnValue(double value, ColumnType column_type) {
+   if (column_type == ColumnType::INT) {
+      return static_cast<int32_t>(value);
+   }
+   if (column_type == ColumnType::DATE) {
+      const auto date_string = silo::common::dateToString(static_cast<silo::common::Date>(value));
+      if (!date_string.has_value()) {
+         return std::nullopt;
+      }
+      return date_string.value();
+   }
+   return value;
+}
+
+}  // namespace
+
+std::string AggregateFunction::getResultName() const {
+   return functionName(type) + "_" + field;
+}
+
+void AggregateFunction::validate(const Database& database) const {
+   const auto& metadata = database.database_config.getMetadata(field);
+   CHECK_SILO_QUERY(
+      metadata.has_value(), "Metadata field '" + field + "' to aggregate not found"
+   )
+   const ColumnType column_type = metadata->getColumnType();
+   CHECK_SILO_QUERY(
+      column_type == ColumnType::INT || column_type == ColumnType::FLOAT ||
+         column_type == ColumnType::DATE,
+      "The aggregate function '" + functionName(type) + "' can only be applied to int, float " +
+         "or date fields, but '" + field + "' is not"
+   )
+   CHECK_SILO_QUERY(
+      column_type != ColumnType::DATE ||
+         (type != AggregateFunctionType::SUM && type != AggregateFunctionType::MEAN),
+      "The aggregate function '" + functionName(type) + "' cannot be applied to the date field '" +
+         field + "'"
+   )
+}
+
+AggregateState::AggregateState(AggregateFunctionType type) {
+   switch (type) {
+      case AggregateFunctionType::SUM:
+      case AggregateFunctionType::MEAN:
+         state = SumState{};
+         return;
+      case AggregateFunctionType::MIN:
+         state = MinState{};
+         return;
+      case AggregateFunctionType::MAX:
+         state = MaxState{};
+         return;
+      case AggregateFunctionType::COUNT_DISTINCT:
+         state = DistinctState{};
+         return;
+   }
+}
+
+void AggregateState::add(double value) {
+   if (auto* sum_state = std::get_if<SumState>(&state)) {
+      ++sum_state->value_count;
+      sum_state->sum += value;
+   } else if (auto* min_state = std::get_if<MinState>(&state)) {
+      min_state->min = std::min(min_state->min.value_or(value), value);
+   } else if (auto* max_state = std::get_if<MaxState>(&state)) {
+      max_state->max = std::max(max_state->max.value_or(value), value);
+   } else {
+      auto& distinct_values = std::get<DistinctState>(state).values;
+      if (distinct_values == nullptr) {
+         distinct_values = std::make_unique<std::unordered_set<double>>();
+      }
+      distinct_values->insert(value);
+   }
+}
+
+AggregateState& AggregateState::operator+=(AggregateState&& other) {
+   if (auto* sum_state = std::get_if<SumState>(&state)) {
+      const auto& other_sum_state = std::get<SumState>(other.state);
+      sum_state->value_count += other_sum_state.value_count;
+      sum_state->sum += other_sum_state.sum;
+   } else if (std::holds_alternative<MinState>(state)) {
+      const auto& other_min = std::get<MinState>(other.state).min;
+      if (other_min.has_value()) {
+         add(*other_min);
+      }
+   } else if (std::holds_alternative<MaxState>(state)) {
+      const auto& other_max = std::get<MaxState>(other.state).max;
+      if (other_max.has_value()) {
+         add(*other_max);
+      }
+   } else {
+      auto& distinct_values = std::get<DistinctState>(state).values;
+      auto& other_distinct_values = std::get<DistinctState>(other.state).values;
+      if (other_distinct_values == nullptr) {
+         return *this;
+      }
+      if (distinct_values == nullptr || distinct_values->size() < other_distinct_values->size()) {
+         std::swap(distinct_values, other_distinct_values);
+      }
+      if (other_distinct_values != nullptr) {
+         distinct_values->merge(*other_distinct_values);
+      }
+   }
+   return *this;
+}
+
+common::JsonValueType AggregateState::getResult(
+   AggregateFunctionType type,
+   ColumnType column_type
+) const {
+   switch (type) {
+      case AggregateFunctionType::SUM: {
+         const auto& sum_state = std::get<SumState>(state);
+         if (sum_state.value_count == 0) {
+            return std::nullopt;
+         }
+         if (column_type == ColumnType::INT && sum_state.sum >= INT32_MIN &&
+             sum_state.sum <= INT32_MAX) {
+            return static_cast<int32_t>(sum_state.sum);
+         }
+         return sum_state.sum;
+      }
+      case AggregateFunctionType::MEAN: {
+         const auto& sum_state = std::get<SumState>(state);
+         if (sum_state.value_count == 0) {
+            return std::nullopt;
+         }
+         return sum_state.sum / sum_state.value_count;
+      }
+      case AggregateFunctionType::MIN: {
+         const auto& min = std::get<MinState>(state).min;
+         return min.has_value() ? toColumnValue(*min, column_type) : std::nullopt;
+      }
+      case AggregateFunctionType::MAX: {
+         const auto& max = std::get<MaxState>(state).max;
+         return max.has_value() ? toColumnValue(*max, column_type) : std::nullopt;
+      }
+      case AggregateFunctionType::COUNT_DISTINCT: {
+         const auto& distinct_values = std::get<DistinctState>(state).values;
+         return static_cast<int32_t>(distinct_values == nullptr ? 0 : distinct_values->size());
+      }
+   }
+   return std::nullopt;
+}
+
+GroupAggregates& GroupAggregates::operator+=(GroupAggregates&& other) {
+   count += other.count;
+   if (states.empty()) {
+      states = std::move(other.states);
+      return *this;
+   }
+   for (size_t i = 0; i < other.states.size(); ++i) {
+      states[i] += std::move(other.states[i]);
+   }
+   return *this;
+}
+
+Aggregator::Aggregator(const std::vector<AggregateFunction>& functions, const Database& database)
+    : functions(functions) {
+   for (const AggregateFunction& function : functions) {
+      const auto& field_metadata = database.database_config.getMetadata(function.field);
+      metadata.push_back({field_metadata->name, field_metadata->getColumnType()});
+   }
+}
+
+void Aggregator::add(
+   GroupAggregates& group,
+   const silo::storage::ColumnPartitionGroup& columns,
+   uint32_t row
+) const {
+   ++group.count;
+   if (group.states.empty()) {
+      group.states.reserve(functions.size());
+      for (const AggregateFunction& function : functions) {
+         group.states.emplace_back(function.type);
+      }
+   }
+   for (size_t i = 0; i < functions.size(); ++i) {
+      const std::optional<double> value = readValue(columns, metadata[i], row);
+      if (value.has_value()) {
+         group.states[i].add(value.value());
+      }
+   }
+}
+
+common::JsonValueType Aggregator::getResult(const GroupAggregates& group, size_t index) const {
+   if (group.states.empty()) {
+      return AggregateState(functions[index].type)
+         .getResult(functions[index].type, metadata[index].type);
+   }
+   return group.states[index].getResult(functions[index].type, metadata[index].type);
+}
+
+void Aggregator::writeResult(
+   const GroupAggregates& group,
+   std::map<std::string, common::JsonValueType>& fields
+) const {
+   for (size_t i = 0; i < functions.size(); ++i) {
+      fields[functions[i].getResultName()] = getResult(group, i);
+   }
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void from_json(const nlohmann::json& json, AggregateFunction& function) {
+   CHECK_SILO_QUERY(
+      json.is_object() && json.contains("function") && json["function"].is_string() &&
+         json.contains("field") && json["field"].is_string(),
+      "The aggregate '" + json.dump() +
+         "' must be an object containing the fields 'function':string and 'field':string"
+   )
+   const std::string function_name = json["function"].get<std::string>();
+   CHECK_SILO_QUERY(
+      AGGREGATE_FUNCTION_NAMES.contains(function_name),
+      "The aggregate function '" + function_name +
+         "' is not supported, it must be one of sum, min, max, mean or countDistinct"
+   )
+   function = {
+      .type = AGGREGATE_FUNCTION_NAMES.at(function_name),
+      .field = json["field"].get<std::string>()
+   };
+}
+
+}  // namespace silo::query_engine::actions
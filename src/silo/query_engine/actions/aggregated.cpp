@@ -1,7 +1,11 @@
 #include "silo/query_engine/actions/aggregated.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
 #include <map>
 #include <optional>
+#include <string>
 #include <unordered_map>
 #include <utility>
 #include <variant>
@@ -10,18 +14,36 @@
 #include <oneapi/tbb/blocked_range.h>
 #include <oneapi/tbb/parallel_for.h>
 #include <nlohmann/json.hpp>
+#include <roaring/roaring.hh>
 
+#include "silo/common/date.h"
+#include "silo/common/types.h"
 #include "silo/config/database_config.h"
 #include "silo/database.h"
+#include "silo/preprocessing/partition.h"
 #include "silo/query_engine/actions/action.h"
+#include "silo/query_engine/actions/aggregate_function.h"
+#include "silo/query_engine/actions/approximation.h"
+#include "silo/query_engine/actions/date_runs.h"
+#include "silo/query_engine/actions/indexed_column.h"
 #include "silo/query_engine/actions/tuple.h"
+#include "silo/query_engine/actions/tuple_map.h"
 #include "silo/query_engine/operator_result.h"
 #include "silo/query_engine/query_parse_exception.h"
 #include "silo/query_engine/query_result.h"
+#include "silo/storage/column/date_column.h"
 #include "silo/storage/column_group.h"
+#include "silo/storage/database_partition.h"
 
 namespace {
 
+using silo::config::ColumnType;
+using silo::query_engine::actions::countIndexedValues;
+using silo::query_engine::actions::getIndexedColumn;
+using silo::query_engine::actions::IndexedColumn;
+using silo::query_engine::actions::isIndexedColumn;
+using silo::query_engine::actions::lookupIndexedValue;
+
 std::vector<silo::storage::ColumnMetadata> parseGroupByFields(
    const silo::Database& database,
    const std::vector<std::string>& group_by_fields
@@ -37,23 +59,244 @@ std::vector<silo::storage::ColumnMetadata> parseGroupByFields(
    return group_by_metadata;
 }
 
+/// Groups are keyed by the value id of the first column in the upper 32 bits and the value id
+/// of the second column (if any) in the lower 32 bits
+using IndexedGroupCounts = silo::query_engine::actions::IndexedValueCounts;
+
+constexpr uint64_t VALUE_ID_BITS = 32;
+
+uint64_t combineValueIds(silo::Idx first_value_id, silo::Idx second_value_id) {
+   return (static_cast<uint64_t>(first_value_id) << VALUE_ID_BITS) | second_value_id;
+}
+
+void countIndexedValuePairs(
+   const IndexedColumn& first_column,
+   const IndexedColumn& second_column,
+   const roaring::Roaring& rows,
+   bool rows_are_full_partition,
+   IndexedGroupCounts& counts
+) {
+   if (rows.cardinality() < first_column.value_bitmaps.size()) {
+      for (const uint32_t row : rows) {
+         ++counts[combineValueIds(first_column.value_ids[row], second_column.value_ids[row])];
+      }
+      return;
+   }
+   for (const auto& [first_value_id, first_value_bitmap] : first_column.value_bitmaps) {
+      const uint64_t key_prefix = combineValueIds(first_value_id, 0);
+      if (rows_are_full_partition) {
+         countIndexedValues(second_column, first_value_bitmap, false, key_prefix, counts);
+         continue;
+      }
+      const roaring::Roaring rows_with_first_value = rows & first_value_bitmap;
+      if (!rows_with_first_value.isEmpty()) {
+         countIndexedValues(second_column, rows_with_first_value, false, key_prefix, counts);
+      }
+   }
+}
+
 }  // namespace
 
 namespace silo::query_engine::actions {
 
 const std::string COUNT_FIELD = "count";
+const std::string COUNT_LOWER_FIELD = "countLower";
+const std::string COUNT_UPPER_FIELD = "countUpper";
+
+/// The order of the groups, if it only depends on their count and aggregate results. Then only
+/// the first `max_groups` groups need to be materialized and sorted.
+struct GroupOrder {
+   struct Field {
+      /// Index into the aggregate functions, or std::nullopt for the count
+      std::optional<size_t> aggregate_index;
+      bool ascending;
+   };
+
+   std::vector<Field> fields;
+   size_t max_groups;
+};
+
+std::optional<GroupOrder> getGroupOrder(
+   const std::vector<OrderByField>& order_by_fields,
+   const std::vector<AggregateFunction>& aggregates,
+   std::optional<uint32_t> limit,
+   std::optional<uint32_t> offset,
+   bool randomize
+) {
+   // A randomized order breaks ties among all groups, not only among the first ones
+   if (!limit.has_value() || order_by_fields.empty() || randomize) {
+      return std::nullopt;
+   }
+   GroupOrder group_order{
+      .fields = {}, .max_groups = static_cast<size_t>(limit.value()) + offset.value_or(0)
+   };
+   for (const OrderByField& field : order_by_fields) {
+      if (field.name == COUNT_FIELD) {
+         group_order.fields.push_back({std::nullopt, field.ascending});
+         continue;
+      }
+      const auto aggregate = std::find_if(
+         aggregates.begin(),
+         aggregates.end(),
+         [&](const AggregateFunction& function) { return function.getResultName() == field.name; }
+      );
+      if (aggregate == aggregates.end()) {
+         return std::nullopt;
+      }
+      group_order.fields.push_back(
+         {static_cast<size_t>(std::distance(aggregates.begin(), aggregate)), field.ascending}
+      );
+   }
+   return group_order;
+}
+
+/// Without aggregate functions, all fields of the GroupOrder are the count
+bool countComesBefore(const GroupOrder& group_order, uint32_t left, uint32_t right) {
+   if (left == right) {
+      return false;
+   }
+   return (left < right) == group_order.fields.front().ascending;
+}
+
+/// Compares like Action::applySort on the written results of the groups
+bool groupComesBefore(
+   const GroupOrder& group_order,
+   const Aggregator& aggregator,
+   const GroupAggregates& left,
+   const GroupAggregates& right
+) {
+   for (const GroupOrder::Field& field : group_order.fields) {
+      if (!field.aggregate_index.has_value()) {
+         if (left.count != right.count) {
+            return (left.count < right.count) == field.ascending;
+         }
+         continue;
+      }
+      const common::JsonValueType left_value = aggregator.getResult(left, *field.aggregate_index);
+      const common::JsonValueType right_value = aggregator.getResult(right, *field.aggregate_index);
+      if (left_value == right_value) {
+         continue;
+      }
+      return left_value < right_value ? field.ascending : !field.ascending;
+   }
+   return false;
+}
+
+/// Materializes the groups of the map. With a GroupOrder, every radix partition keeps only its
+/// first `max_groups` groups in a bounded heap, so that fields are only generated for candidates.
+template <typename Value, typename WriteValue, typename ComesBefore>
+std::vector<QueryResultEntry> generateResult(
+   TupleMap<Value>& tuple_map,
+   WriteValue write_value,
+   const std::optional<GroupOrder>& group_order,
+   ComesBefore comes_before
+) {
+   using Candidate = std::pair<const Value*, QueryResultEntry>;
+   const auto candidate_comes_before = [&](const Candidate& left, const Candidate& right) {
+      return comes_before(*left.first, *right.first);
+   };
+
+   std::vector<std::vector<Candidate>> candidates_per_radix_partition(
+      TupleMap<Value>::RADIX_PARTITION_COUNT
+   );
+   tbb::parallel_for(
+      tbb::blocked_range<uint32_t>(0, TupleMap<Value>::RADIX_PARTITION_COUNT),
+      [&](const tbb::blocked_range<uint32_t>& range) {
+         for (uint32_t radix_partition = range.begin(); radix_partition != range.end();
+              ++radix_partition) {
+            auto& candidates = candidates_per_radix_partition[radix_partition];
+            tuple_map.forEachInRadixPartition(
+               radix_partition,
+               [&](const Tuple& tuple, Value& value) {
+                  if (group_order.has_value() && candidates.size() == group_order->max_groups) {
+                     // The front of the heap is the last of the first groups seen so far
+                     if (candidates.empty() || !comes_before(value, *candidates.front().first)) {
+                        return;
+                     }
+                     std::pop_heap(candidates.begin(), candidates.end(), candidate_comes_before);
+                     candidates.pop_back();
+                  }
+                  std::map<std::string, common::JsonValueType> fields = tuple.getFields();
+                  write_value(value, fields);
+                  candidates.emplace_back(&value, QueryResultEntry{std::move(fields)});
+                  if (group_order.has_value()) {
+                     std::push_heap(candidates.begin(), candidates.end(), candidate_comes_before);
+                  }
+               }
+            );
+         }
+      }
+   );
 
-std::vector<QueryResultEntry> generateResult(std::unordered_map<Tuple, uint32_t>& tuple_counts) {
+   std::vector<Candidate> candidates;
+   for (auto& partial_candidates : candidates_per_radix_partition) {
+      std::move(
+         partial_candidates.begin(), partial_candidates.end(), std::back_inserter(candidates)
+      );
+   }
+   if (group_order.has_value() && candidates.size() > group_order->max_groups) {
+      std::nth_element(
+         candidates.begin(),
+         candidates.begin() + static_cast<int64_t>(group_order->max_groups),
+         candidates.end(),
+         candidate_comes_before
+      );
+      candidates.resize(group_order->max_groups);
+   }
    std::vector<QueryResultEntry> result;
-   result.reserve(tuple_counts.size());
-   for (auto& [tuple, count] : tuple_counts) {
-      std::map<std::string, common::JsonValueType> fields = tuple.getFields();
-      fields[COUNT_FIELD] = static_cast<int32_t>(count);
-      result.push_back({fields});
+   result.reserve(candidates.size());
+   for (auto& candidate : candidates) {
+      result.push_back(std::move(candidate.second));
    }
    return result;
 }
 
+std::vector<QueryResultEntry> generateResult(
+   TupleCountMap& tuple_counts,
+   const std::optional<GroupOrder>& group_order
+) {
+   return generateResult(
+      tuple_counts,
+      [](uint32_t count, std::map<std::string, common::JsonValueType>& fields) {
+         fields[COUNT_FIELD] = static_cast<int32_t>(count);
+      },
+      group_order,
+      [&](uint32_t left, uint32_t right) { return countComesBefore(*group_order, left, right); }
+   );
+}
+
+void countTuples(TupleFactory& tuple_factory, const roaring::Roaring& rows, TupleCountMap& map) {
+   auto iterator = rows.begin();
+   auto end = rows.end();
+   if (iterator == end) {
+      return;
+   }
+   Tuple current_tuple = tuple_factory.allocateOne(*iterator);
+   ++map[current_tuple];
+   iterator++;
+   for (; iterator != end; iterator++) {
+      tuple_factory.overwrite(current_tuple, *iterator);
+      ++map[current_tuple];
+   }
+}
+
+void aggregateTuples(
+   TupleFactory& tuple_factory,
+   const Aggregator& aggregator,
+   const silo::storage::ColumnPartitionGroup& columns,
+   const roaring::Roaring& rows,
+   TupleMap<GroupAggregates>& map
+) {
+   if (rows.isEmpty()) {
+      return;
+   }
+   Tuple current_tuple = tuple_factory.allocateOne(rows.minimum());
+   for (const uint32_t row : rows) {
+      tuple_factory.overwrite(current_tuple, row);
+      aggregator.add(map[current_tuple], columns, row);
+   }
+}
+
 QueryResult aggregateWithoutGrouping(const std::vector<OperatorResult>& bitmap_filters) {
    uint32_t count = 0;
    for (const auto& filter : bitmap_filters) {
@@ -64,8 +307,479 @@ QueryResult aggregateWithoutGrouping(const std::vector<OperatorResult>& bitmap_f
    return QueryResult{std::vector<QueryResultEntry>{{tuple_fields}}};
 }
 
-Aggregated::Aggregated(std::vector<std::string> group_by_fields)
-    : group_by_fields(std::move(group_by_fields)) {}
+/// Group-by on one or two indexed columns: the counts are computed from the cardinalities of the
+/// value bitmaps of these columns, without materializing a Tuple for every row
+QueryResult aggregateIndexedColumns(
+   const Database& database,
+   const std::vector<silo::storage::ColumnMetadata>& group_by_metadata,
+   const std::vector<OperatorResult>& bitmap_filters,
+   const std::optional<GroupOrder>& group_order
+) {
+   std::vector<IndexedGroupCounts> counts_per_partition(database.partitions.size());
+
+   tbb::parallel_for(
+      tbb::blocked_range<uint32_t>(0, database.partitions.size()),
+      [&](tbb::blocked_range<uint32_t> range) {
+         for (uint32_t partition_id = range.begin(); partition_id != range.end(); ++partition_id) {
+            const DatabasePartition& partition = database.partitions.at(partition_id);
+            const roaring::Roaring& bitmap = *bitmap_filters[partition_id];
+            if (bitmap.isEmpty()) {
+               continue;
+            }
+            const bool bitmap_is_full = bitmap.cardinality() == partition.sequence_count;
+            const IndexedColumn first_column =
+               getIndexedColumn(partition.columns, group_by_metadata.at(0));
+            if (group_by_metadata.size() == 1) {
+               countIndexedValues(
+                  first_column, bitmap, bitmap_is_full, 0, counts_per_partition[partition_id]
+               );
+            } else {
+               countIndexedValuePairs(
+                  first_column,
+                  getIndexedColumn(partition.columns, group_by_metadata.at(1)),
+                  bitmap,
+                  bitmap_is_full,
+                  counts_per_partition[partition_id]
+               );
+            }
+         }
+      }
+   );
+
+   IndexedGroupCounts final_counts;
+   for (const auto& counts : counts_per_partition) {
+      for (const auto& [key, count] : counts) {
+         final_counts[key] += count;
+      }
+   }
+
+   if (database.partitions.empty()) {
+      return {};
+   }
+   std::vector<std::pair<uint64_t, uint32_t>> groups(final_counts.begin(), final_counts.end());
+   if (group_order.has_value() && groups.size() > group_order->max_groups) {
+      std::nth_element(
+         groups.begin(),
+         groups.begin() + static_cast<int64_t>(group_order->max_groups),
+         groups.end(),
+         [&](const auto& left, const auto& right) {
+            return countComesBefore(*group_order, left.second, right.second);
+         }
+      );
+      groups.resize(group_order->max_groups);
+   }
+
+   // The dictionaries of indexed columns are shared by all partitions
+   const silo::storage::ColumnPartitionGroup& columns = database.partitions.front().columns;
+   std::vector<QueryResultEntry> result;
+   result.reserve(groups.size());
+   for (const auto& [key, count] : groups) {
+      std::map<std::string, common::JsonValueType> fields;
+      if (group_by_metadata.size() == 1) {
+         fields[group_by_metadata.at(0).name] =
+            lookupIndexedValue(columns, group_by_metadata.at(0), static_cast<Idx>(key));
+      } else {
+         fields[group_by_metadata.at(0).name] = lookupIndexedValue(
+            columns, group_by_metadata.at(0), static_cast<Idx>(key >> VALUE_ID_BITS)
+         );
+         fields[group_by_metadata.at(1).name] =
+            lookupIndexedValue(columns, group_by_metadata.at(1), static_cast<Idx>(key));
+      }
+      fields[COUNT_FIELD] = static_cast<int32_t>(count);
+      result.push_back({fields});
+   }
+   return QueryResult{std::move(result)};
+}
+
+/// Group-by that includes the partition_by column. Partitions are built from ranges of values of
+/// this column and mostly hold a single one of them, so the rows of a partition are split by the
+/// value bitmaps of the partition_by column and only the remaining fields are hashed per row
+QueryResult aggregateWithPartitionByColumn(
+   const Database& database,
+   const std::vector<silo::storage::ColumnMetadata>& group_by_metadata,
+   const std::vector<OperatorResult>& bitmap_filters,
+   const std::optional<GroupOrder>& group_order
+) {
+   const std::string& partition_by = database.database_config.schema.partition_by.value();
+   std::optional<silo::storage::ColumnMetadata> partition_by_metadata;
+   std::vector<silo::storage::ColumnMetadata> other_metadata;
+   for (const auto& metadata : group_by_metadata) {
+      if (metadata.name == partition_by) {
+         partition_by_metadata = metadata;
+      } else {
+         other_metadata.push_back(metadata);
+      }
+   }
+
+   if (database.partitions.empty()) {
+      return {};
+   }
+
+   using TupleCountsByValue = std::unordered_map<Idx, TupleCountMap>;
+   std::vector<TupleCountsByValue> counts_per_partition(database.partitions.size());
+   std::vector<TupleFactory> tuple_factories;
+   for (const auto& partition : database.partitions) {
+      tuple_factories.emplace_back(partition.columns, other_metadata);
+   }
+
+   tbb::parallel_for(
+      tbb::blocked_range<uint32_t>(0, database.partitions.size()),
+      [&](tbb::blocked_range<uint32_t> range) {
+         for (uint32_t partition_id = range.begin(); partition_id != range.end(); ++partition_id) {
+            const DatabasePartition& partition = database.partitions.at(partition_id);
+            const roaring::Roaring& bitmap = *bitmap_filters[partition_id];
+            if (bitmap.isEmpty()) {
+               continue;
+            }
+            TupleFactory& tuple_factory = tuple_factories.at(partition_id);
+            TupleCountsByValue& counts = counts_per_partition[partition_id];
+            const auto& value_bitmaps =
+               getIndexedColumn(partition.columns, *partition_by_metadata).value_bitmaps;
+            if (value_bitmaps.size() == 1) {
+               const Idx value_id = value_bitmaps.begin()->first;
+               TupleCountMap& map = counts.emplace(value_id, tuple_factory).first->second;
+               countTuples(tuple_factory, bitmap, map);
+               continue;
+            }
+            for (const auto& [value_id, value_bitmap] : value_bitmaps) {
+               const roaring::Roaring rows = bitmap & value_bitmap;
+               if (!rows.isEmpty()) {
+                  TupleCountMap& map = counts.emplace(value_id, tuple_factory).first->second;
+                  countTuples(tuple_factory, rows, map);
+               }
+            }
+         }
+      }
+   );
+
+   std::unordered_map<Idx, std::vector<TupleCountMap>> maps_by_value;
+   for (auto& counts : counts_per_partition) {
+      for (auto& [value_id, map] : counts) {
+         maps_by_value[value_id].push_back(std::move(map));
+      }
+   }
+
+   // The dictionaries of the columns are shared by all partitions
+   const TupleFactory& tuple_factory = tuple_factories.front();
+   const silo::storage::ColumnPartitionGroup& columns = database.partitions.front().columns;
+   std::vector<QueryResultEntry> result;
+   for (auto& [value_id, maps] : maps_by_value) {
+      TupleCountMap final_map = TupleCountMap::merge(tuple_factory, maps);
+      const common::JsonValueType partition_by_value =
+         lookupIndexedValue(columns, *partition_by_metadata, value_id);
+      for (auto& entry : generateResult(final_map, group_order)) {
+         entry.fields[partition_by] = partition_by_value;
+         result.push_back(std::move(entry));
+      }
+   }
+   return QueryResult{std::move(result)};
+}
+
+/// Group-by with aggregate functions. Every partition accumulates mergeable partial states per
+/// group, which are merged like the counts.
+QueryResult aggregateWithFunctions(
+   const Database& database,
+   const std::vector<silo::storage::ColumnMetadata>& group_by_metadata,
+   const std::vector<AggregateFunction>& aggregates,
+   const std::vector<OperatorResult>& bitmap_filters,
+   const std::optional<GroupOrder>& group_order
+) {
+   const Aggregator aggregator(aggregates, database);
+   std::vector<QueryResultEntry> result;
+
+   if (!database.partitions.empty()) {
+      std::vector<TupleFactory> tuple_factories;
+      for (const auto& partition : database.partitions) {
+         tuple_factories.emplace_back(partition.columns, group_by_metadata);
+      }
+      std::vector<TupleMap<GroupAggregates>> tuple_maps;
+      for (const auto& tuple_factory : tuple_factories) {
+         tuple_maps.emplace_back(tuple_factory);
+      }
+
+      tbb::parallel_for(
+         tbb::blocked_range<uint32_t>(0, database.partitions.size()),
+         [&](tbb::blocked_range<uint32_t> range) {
+            for (uint32_t partition_id = range.begin(); partition_id != range.end();
+                 ++partition_id) {
+               aggregateTuples(
+                  tuple_factories.at(partition_id),
+                  aggregator,
+                  database.partitions.at(partition_id).columns,
+                  *bitmap_filters[partition_id],
+                  tuple_maps.at(partition_id)
+               );
+            }
+         }
+      );
+      auto final_map = TupleMap<GroupAggregates>::merge(tuple_factories.front(), tuple_maps);
+      result = generateResult(
+         final_map,
+         [&](const GroupAggregates& group, std::map<std::string, common::JsonValueType>& fields) {
+            fields[COUNT_FIELD] = static_cast<int32_t>(group.count);
+            aggregator.writeResult(group, fields);
+         },
+         group_order,
+         [&](const GroupAggregates& left, const GroupAggregates& right) {
+            return groupComesBefore(*group_order, aggregator, left, right);
+         }
+      );
+   }
+
+   // Without grouping, there is exactly one result, even if no rows match
+   if (group_by_metadata.empty() && result.empty()) {
+      std::map<std::string, common::JsonValueType> fields;
+      fields[COUNT_FIELD] = 0;
+      aggregator.writeResult(GroupAggregates{}, fields);
+      result.push_back({std::move(fields)});
+   }
+   return QueryResult{std::move(result)};
+}
+
+/// Group-by on only a truncated date. For sorted date columns, the counts are the numbers of
+/// filtered rows in the runs of equal truncated dates.
+QueryResult countTruncatedDates(
+   const Database& database,
+   const TruncatedDateField& truncated_date_field,
+   const std::vector<OperatorResult>& bitmap_filters,
+   const std::optional<GroupOrder>& group_order
+) {
+   std::vector<std::unordered_map<common::Date, uint32_t>> counts_per_partition(
+      database.partitions.size()
+   );
+
+   tbb::parallel_for(
+      tbb::blocked_range<uint32_t>(0, database.partitions.size()),
+      [&](tbb::blocked_range<uint32_t> range) {
+         for (uint32_t partition_id = range.begin(); partition_id != range.end(); ++partition_id) {
+            const DatabasePartition& partition = database.partitions.at(partition_id);
+            const roaring::Roaring& bitmap = *bitmap_filters[partition_id];
+            if (bitmap.isEmpty()) {
+               continue;
+            }
+            const auto& date_column = partition.columns.date_columns.at(truncated_date_field.name);
+            auto& counts = counts_per_partition[partition_id];
+            if (!date_column.isSorted()) {
+               for (const uint32_t row : bitmap) {
+                  ++counts[common::truncateDate(
+                     date_column.getValues()[row], truncated_date_field.truncation
+                  )];
+               }
+               continue;
+            }
+            for (const auto& run : getTruncatedDateRuns(
+                    date_column.getValues(), partition.getChunks(), truncated_date_field.truncation
+                 )) {
+               const uint64_t count = countRowsInRange(bitmap, run.begin, run.end);
+               if (count > 0) {
+                  counts[run.date] += count;
+               }
+            }
+         }
+      }
+   );
+
+   std::unordered_map<common::Date, uint32_t> final_counts;
+   for (const auto& counts : counts_per_partition) {
+      for (const auto& [date, count] : counts) {
+         final_counts[date] += count;
+      }
+   }
+   std::vector<std::pair<common::Date, uint32_t>> groups(final_counts.begin(), final_counts.end());
+   if (group_order.has_value() && groups.size() > group_order->max_groups) {
+      std::nth_element(
+         groups.begin(),
+         groups.begin() + static_cast<int64_t>(group_order->max_groups),
+         groups.end(),
+         [&](const auto& left, const auto& right) {
+            return countComesBefore(*group_order, left.second, right.second);
+         }
+      );
+      groups.resize(group_order->max_groups);
+   }
+
+   std::vector<QueryResultEntry> result;
+   result.reserve(groups.size());
+   for (const auto& [date, count] : groups) {
+      std::map<std::string, common::JsonValueType> fields;
+      fields[truncated_date_field.name] = common::dateToString(date);
+      fields[COUNT_FIELD] = static_cast<int32_t>(count);
+      result.push_back({fields});
+   }
+   return QueryResult{std::move(result)};
+}
+
+/// Group-by on a truncated date and other fields. The filtered rows of every partition are split
+/// by their truncated date, and the other fields are aggregated per truncated date, like per value
+/// of the partition_by column.
+template <typename Value, typename AddRows, typename WriteValue, typename ComesBefore>
+QueryResult aggregateByTruncatedDate(
+   const Database& database,
+   const std::vector<silo::storage::ColumnMetadata>& group_by_metadata,
+   const TruncatedDateField& truncated_date_field,
+   const std::vector<OperatorResult>& bitmap_filters,
+   AddRows add_rows,
+   WriteValue write_value,
+   const std::optional<GroupOrder>& group_order,
+   ComesBefore comes_before
+) {
+   std::vector<silo::storage::ColumnMetadata> other_metadata;
+   std::copy_if(
+      group_by_metadata.begin(),
+      group_by_metadata.end(),
+      std::back_inserter(other_metadata),
+      [&](const silo::storage::ColumnMetadata& metadata) {
+         return metadata.name != truncated_date_field.name;
+      }
+   );
+
+   if (database.partitions.empty()) {
+      return {};
+   }
+
+   using TupleMapsByDate = std::unordered_map<common::Date, TupleMap<Value>>;
+   std::vector<TupleMapsByDate> maps_per_partition(database.partitions.size());
+   std::vector<TupleFactory> tuple_factories;
+   for (const auto& partition : database.partitions) {
+      tuple_factories.emplace_back(partition.columns, other_metadata);
+   }
+
+   tbb::parallel_for(
+      tbb::blocked_range<uint32_t>(0, database.partitions.size()),
+      [&](tbb::blocked_range<uint32_t> range) {
+         for (uint32_t partition_id = range.begin(); partition_id != range.end(); ++partition_id) {
+            const DatabasePartition& partition = database.partitions.at(partition_id);
+            const roaring::Roaring& bitmap = *bitmap_filters[partition_id];
+            if (bitmap.isEmpty()) {
+               continue;
+            }
+            const auto& date_column = partition.columns.date_columns.at(truncated_date_field.name);
+            std::unordered_map<common::Date, roaring::Roaring> rows_by_date;
+            if (!date_column.isSorted()) {
+               for (const uint32_t row : bitmap) {
+                  rows_by_date[common::truncateDate(
+                                  date_column.getValues()[row], truncated_date_field.truncation
+                               )]
+                     .add(row);
+               }
+            } else {
+               for (const auto& run : getTruncatedDateRuns(
+                       date_column.getValues(),
+                       partition.getChunks(),
+                       truncated_date_field.truncation
+                    )) {
+                  roaring::Roaring rows;
+                  rows.addRange(run.begin, run.end);
+                  rows &= bitmap;
+                  if (!rows.isEmpty()) {
+                     rows_by_date[run.date] |= rows;
+                  }
+               }
+            }
+            TupleFactory& tuple_factory = tuple_factories.at(partition_id);
+            for (const auto& [date, rows] : rows_by_date) {
+               TupleMap<Value>& map =
+                  maps_per_partition[partition_id].emplace(date, tuple_factory).first->second;
+               add_rows(tuple_factory, partition.columns, rows, map);
+            }
+         }
+      }
+   );
+
+   std::unordered_map<common::Date, std::vector<TupleMap<Value>>> maps_by_date;
+   for (auto& maps : maps_per_partition) {
+      for (auto& [date, map] : maps) {
+         maps_by_date[date].push_back(std::move(map));
+      }
+   }
+
+   const TupleFactory& tuple_factory = tuple_factories.front();
+   std::vector<QueryResultEntry> result;
+   for (auto& [date, maps] : maps_by_date) {
+      TupleMap<Value> final_map = TupleMap<Value>::merge(tuple_factory, maps);
+      const common::JsonValueType date_value = common::dateToString(date);
+      for (auto& entry : generateResult(final_map, write_value, group_order, comes_before)) {
+         entry.fields[truncated_date_field.name] = date_value;
+         result.push_back(std::move(entry));
+      }
+   }
+   return QueryResult{std::move(result)};
+}
+
+QueryResult aggregateWithTruncatedDate(
+   const Database& database,
+   const std::vector<silo::storage::ColumnMetadata>& group_by_metadata,
+   const TruncatedDateField& truncated_date_field,
+   const std::vector<AggregateFunction>& aggregates,
+   const std::vector<OperatorResult>& bitmap_filters,
+   const std::optional<GroupOrder>& group_order
+) {
+   CHECK_SILO_QUERY(
+      std::any_of(
+         group_by_metadata.begin(),
+         group_by_metadata.end(),
+         [&](const silo::storage::ColumnMetadata& metadata) {
+            return metadata.name == truncated_date_field.name &&
+                   metadata.type == ColumnType::DATE;
+         }
+      ),
+      "The groupByField '" + truncated_date_field.name +
+         "' can only be truncated if it is a date field"
+   )
+
+   if (aggregates.empty() && group_by_metadata.size() == 1) {
+      return countTruncatedDates(database, truncated_date_field, bitmap_filters, group_order);
+   }
+   if (aggregates.empty()) {
+      return aggregateByTruncatedDate<uint32_t>(
+         database,
+         group_by_metadata,
+         truncated_date_field,
+         bitmap_filters,
+         [](TupleFactory& tuple_factory,
+            const silo::storage::ColumnPartitionGroup& /*columns*/,
+            const roaring::Roaring& rows,
+            TupleCountMap& map) { countTuples(tuple_factory, rows, map); },
+         [](uint32_t count, std::map<std::string, common::JsonValueType>& fields) {
+            fields[COUNT_FIELD] = static_cast<int32_t>(count);
+         },
+         group_order,
+         [&](uint32_t left, uint32_t right) { return countComesBefore(*group_order, left, right); }
+      );
+   }
+   const Aggregator aggregator(aggregates, database);
+   return aggregateByTruncatedDate<GroupAggregates>(
+      database,
+      group_by_metadata,
+      truncated_date_field,
+      bitmap_filters,
+      [&](TupleFactory& tuple_factory,
+          const silo::storage::ColumnPartitionGroup& columns,
+          const roaring::Roaring& rows,
+          TupleMap<GroupAggregates>& map) {
+         aggregateTuples(tuple_factory, aggregator, columns, rows, map);
+      },
+      [&](const GroupAggregates& group, std::map<std::string, common::JsonValueType>& fields) {
+         fields[COUNT_FIELD] = static_cast<int32_t>(group.count);
+         aggregator.writeResult(group, fields);
+      },
+      group_order,
+      [&](const GroupAggregates& left, const GroupAggregates& right) {
+         return groupComesBefore(*group_order, aggregator, left, right);
+      }
+   );
+}
+
+Aggregated::Aggregated(
+   std::vector<std::string> group_by_fields,
+   std::optional<TruncatedDateField> truncated_date_field,
+   std::vector<AggregateFunction> aggregates,
+   std::optional<Approximation> approximation
+)
+    : group_by_fields(std::move(group_by_fields)),
+      truncated_date_field(std::move(truncated_date_field)),
+      aggregates(std::move(aggregates)),
+      approximation(std::move(approximation)) {}
 
 void Aggregated::validateOrderByFields(const Database& database) const {
    const std::vector<silo::storage::ColumnMetadata> field_metadata =
@@ -73,13 +787,23 @@ void Aggregated::validateOrderByFields(const Database& database) const {
 
    for (const OrderByField& field : order_by_fields) {
       CHECK_SILO_QUERY(
-         field.name == COUNT_FIELD || std::any_of(
-                                         field_metadata.begin(),
-                                         field_metadata.end(),
-                                         [&](const silo::storage::ColumnMetadata& metadata) {
-                                            return metadata.name == field.name;
-                                         }
-                                      ),
+         field.name == COUNT_FIELD ||
+            (approximation.has_value() &&
+             (field.name == COUNT_LOWER_FIELD || field.name == COUNT_UPPER_FIELD)) ||
+            std::any_of(
+               field_metadata.begin(),
+               field_metadata.end(),
+               [&](const silo::storage::ColumnMetadata& metadata) {
+                  return metadata.name == field.name;
+               }
+            ) ||
+            std::any_of(
+               aggregates.begin(),
+               aggregates.end(),
+               [&](const AggregateFunction& aggregate) {
+                  return aggregate.getResultName() == field.name;
+               }
+            ),
          "The orderByField '" + field.name +
             "' cannot be ordered by, as it does not appear in the groupByFields."
       )
@@ -90,69 +814,168 @@ QueryResult Aggregated::execute(
    const Database& database,
    std::vector<OperatorResult> bitmap_filters
 ) const {
+   if (!approximation.has_value()) {
+      return executeExact(database, bitmap_filters);
+   }
    if (group_by_fields.empty()) {
+      // The count without groups is the cardinality of the filter, which is exact and cheaper
+      // than a sample
+      QueryResult result = executeExact(database, bitmap_filters);
+      for (auto& entry : result.query_result) {
+         entry.fields[COUNT_LOWER_FIELD] = entry.fields.at(COUNT_FIELD);
+         entry.fields[COUNT_UPPER_FIELD] = entry.fields.at(COUNT_FIELD);
+      }
+      return result;
+   }
+   const FilterSample filter_sample = sampleFilter(database, bitmap_filters, *approximation);
+   QueryResult result = executeExact(database, bitmap_filters);
+   for (auto& entry : result.query_result) {
+      const auto sample_count = std::get<int32_t>(entry.fields.at(COUNT_FIELD).value());
+      const CountEstimate estimate = filter_sample.estimateCount(sample_count);
+      entry.fields[COUNT_FIELD] = static_cast<int32_t>(estimate.count);
+      entry.fields[COUNT_LOWER_FIELD] = static_cast<int32_t>(estimate.lower);
+      entry.fields[COUNT_UPPER_FIELD] = static_cast<int32_t>(estimate.upper);
+   }
+   return result;
+}
+
+QueryResult Aggregated::executeExact(
+   const Database& database,
+   std::vector<OperatorResult>& bitmap_filters
+) const {
+   for (const AggregateFunction& aggregate : aggregates) {
+      aggregate.validate(database);
+   }
+   if (group_by_fields.empty() && aggregates.empty()) {
       return aggregateWithoutGrouping(bitmap_filters);
    }
-   // TODO(#133) optimize when equal to partition_by field
-   // TODO(#133) optimize single field groupby
 
    const std::vector<silo::storage::ColumnMetadata> group_by_metadata =
       parseGroupByFields(database, group_by_fields);
+   const std::optional<GroupOrder> group_order =
+      getGroupOrder(order_by_fields, aggregates, limit, offset, randomize_seed.has_value());
 
-   std::vector<std::unordered_map<Tuple, uint32_t>> tuple_maps;
-   std::vector<TupleFactory> tuple_factories;
+   if (truncated_date_field.has_value()) {
+      return aggregateWithTruncatedDate(
+         database,
+         group_by_metadata,
+         *truncated_date_field,
+         aggregates,
+         bitmap_filters,
+         group_order
+      );
+   }
+
+   if (!aggregates.empty()) {
+      return aggregateWithFunctions(
+         database, group_by_metadata, aggregates, bitmap_filters, group_order
+      );
+   }
+
+   if (group_by_metadata.size() <= 2 &&
+       std::all_of(group_by_metadata.begin(), group_by_metadata.end(), isIndexedColumn)) {
+      return aggregateIndexedColumns(database, group_by_metadata, bitmap_filters, group_order);
+   }
 
+   const auto& partition_by = database.database_config.schema.partition_by;
+   if (partition_by.has_value() &&
+       std::any_of(
+          group_by_metadata.begin(),
+          group_by_metadata.end(),
+          [&](const silo::storage::ColumnMetadata& metadata) {
+             return metadata.name == *partition_by;
+          }
+       )) {
+      return aggregateWithPartitionByColumn(
+         database, group_by_metadata, bitmap_filters, group_order
+      );
+   }
+
+   if (database.partitions.empty()) {
+      return {};
+   }
+
+   std::vector<TupleFactory> tuple_factories;
    for (const auto& partition : database.partitions) {
-      tuple_maps.emplace_back();
       tuple_factories.emplace_back(partition.columns, group_by_metadata);
    }
+   std::vector<TupleCountMap> tuple_maps;
+   for (const auto& tuple_factory : tuple_factories) {
+      tuple_maps.emplace_back(tuple_factory);
+   }
 
    tbb::parallel_for(
       tbb::blocked_range<uint32_t>(0, database.partitions.size()),
       [&](tbb::blocked_range<uint32_t> range) {
          for (uint32_t partition_id = range.begin(); partition_id != range.end(); ++partition_id) {
-            TupleFactory& tuple_factory = tuple_factories.at(partition_id);
-            std::unordered_map<Tuple, uint32_t>& map = tuple_maps.at(partition_id);
-            OperatorResult& bitmap = bitmap_filters[partition_id];
-
-            auto iterator = bitmap->begin();
-            auto end = bitmap->end();
-            if (iterator != end) {
-               Tuple current_tuple = tuple_factory.allocateOne(*iterator);
-               map.emplace(tuple_factory.copyTuple(current_tuple), 1);
-               iterator++;
-               for (; iterator != end; iterator++) {
-                  tuple_factory.overwrite(current_tuple, *iterator);
-                  if (map.contains(current_tuple)) {
-                     ++map.at(current_tuple);
-                  } else {
-                     map.emplace(tuple_factory.copyTuple(current_tuple), 1);
-                  }
-               }
-            }
+            countTuples(
+               tuple_factories.at(partition_id),
+               *bitmap_filters[partition_id],
+               tuple_maps.at(partition_id)
+            );
          }
       }
    );
-   std::unordered_map<Tuple, uint32_t> final_map;
-   for (uint32_t partition_id = 0; partition_id != database.partitions.size(); ++partition_id) {
-      auto& tuple_factory = tuple_factories.at(partition_id);
-      auto& map = tuple_maps.at(partition_id);
-      for (auto& [tuple, value] : map) {
-         if (final_map.contains(tuple)) {
-            final_map.at(tuple) += value;
-         } else {
-            final_map.emplace(tuple_factory.copyTuple(tuple), value);
-         }
-      }
-   }
-   return QueryResult{generateResult(final_map)};
+   TupleCountMap final_map = TupleCountMap::merge(tuple_factories.front(), tuple_maps);
+   return QueryResult{generateResult(final_map, group_order)};
 }
 
 // NOLINTNEXTLINE(readability-identifier-naming)
 void from_json(const nlohmann::json& json, std::unique_ptr<Aggregated>& action) {
-   const std::vector<std::string> group_by_fields =
-      json.value("groupByFields", std::vector<std::string>());
-   action = std::make_unique<Aggregated>(group_by_fields);
+   CHECK_SILO_QUERY(
+      !json.contains("groupByFields") || json["groupByFields"].is_array(),
+      "The field 'groupByFields' of the Aggregated action must be an array"
+   )
+   std::vector<std::string> group_by_fields;
+   std::optional<TruncatedDateField> truncated_date_field;
+   for (const auto& field : json.value("groupByFields", nlohmann::json::array())) {
+      if (field.is_string()) {
+         group_by_fields.push_back(field.get<std::string>());
+         continue;
+      }
+      CHECK_SILO_QUERY(
+         field.is_object() && field.contains("field") && field["field"].is_string() &&
+            field.contains("truncateTo") && field["truncateTo"].is_string() &&
+            DATE_TRUNCATION_NAMES.contains(field["truncateTo"].get<std::string>()),
+         "The groupByField '" + field.dump() +
+            "' must be either a string or an object containing the fields 'field':string and "
+            "'truncateTo':string, where the value of truncateTo is 'day', 'week', 'month', "
+            "'quarter' or 'year'"
+      )
+      CHECK_SILO_QUERY(
+         !truncated_date_field.has_value(), "Only one of the groupByFields can be truncated"
+      )
+      truncated_date_field = {
+         .name = field["field"].get<std::string>(),
+         .truncation = DATE_TRUNCATION_NAMES.at(field["truncateTo"].get<std::string>())
+      };
+      group_by_fields.push_back(truncated_date_field->name);
+   }
+   CHECK_SILO_QUERY(
+      !json.contains("aggregates") || json["aggregates"].is_array(),
+      "The field 'aggregates' of the Aggregated action must be an array"
+   )
+   const std::vector<AggregateFunction> aggregates =
+      json.value("aggregates", std::vector<AggregateFunction>());
+   for (const AggregateFunction& aggregate : aggregates) {
+      const std::string result_name = aggregate.getResultName();
+      const bool is_group_by_field =
+         std::find(group_by_fields.begin(), group_by_fields.end(), result_name) !=
+         group_by_fields.end();
+      CHECK_SILO_QUERY(
+         result_name != COUNT_FIELD && !is_group_by_field,
+         "The result field '" + result_name +
+            "' of an aggregate of the Aggregated action collides with the count or a groupByField"
+      )
+   }
+   const std::optional<Approximation> approximation = parseApproximation(json, "Aggregated");
+   CHECK_SILO_QUERY(
+      !approximation.has_value() || aggregates.empty(),
+      "The Aggregated action can only approximate counts, it cannot be combined with aggregates"
+   )
+   action = std::make_unique<Aggregated>(
+      group_by_fields, truncated_date_field, aggregates, approximation
+   );
 }
 
 }  // namespace silo::query_engine::actions
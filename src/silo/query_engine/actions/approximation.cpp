@@ -0,0 +1,136 @@
+#include "silo/query_engine/actions/approximation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <nlohmann/json.hpp>
+#include <roaring/roaring.hh>
+
+#include "silo/database.h"
+#include "silo/query_engine/operator_result.h"
+#include "silo/query_engine/query_parse_exception.h"
+#include "silo/storage/database_partition.h"
+#include "silo/storage/row_sample.h"
+
+namespace silo::query_engine::actions {
+
+namespace {
+
+/// z-value of the two-sided 95% confidence interval of the normal distribution
+constexpr double Z_95 = 1.959963984540054;
+
+}  // namespace
+
+bool FilterSample::isExact() const {
+   return population == sample_size;
+}
+
+CountEstimate FilterSample::estimateCount(uint64_t sample_count) const {
+   if (isExact()) {
+      return {sample_count, sample_count, sample_count};
+   }
+   const ProportionEstimate proportion = estimateProportion(sample_count, sample_size);
+   const auto population_double = static_cast<double>(population);
+   // The sampled rows that do not match are known to not match in the population either
+   const uint64_t lower_limit = sample_count;
+   const uint64_t upper_limit = population - (sample_size - sample_count);
+   const auto clamp = [&](double count) {
+      return std::clamp(static_cast<uint64_t>(count), lower_limit, upper_limit);
+   };
+   return {
+      clamp(std::round(proportion.proportion * population_double)),
+      clamp(std::floor(proportion.lower * population_double)),
+      clamp(std::ceil(proportion.upper * population_double))
+   };
+}
+
+ProportionEstimate FilterSample::estimateProportion(uint64_t sample_count, uint64_t sample_total)
+   const {
+   if (sample_total == 0) {
+      return {0.0, 0.0, isExact() ? 0.0 : 1.0};
+   }
+   const auto total = static_cast<double>(sample_total);
+   const double proportion = static_cast<double>(sample_count) / total;
+   if (isExact()) {
+      return {proportion, proportion, proportion};
+   }
+   // Wilson score interval, which stays within [0, 1] and does not collapse to a single value for
+   // proportions close to 0 or 1
+   const double z_squared = Z_95 * Z_95;
+   const double center = (proportion + z_squared / (2 * total)) / (1 + z_squared / total);
+   const double half_width =
+      Z_95 / (1 + z_squared / total) *
+      std::sqrt(proportion * (1 - proportion) / total + z_squared / (4 * total * total));
+   return {proportion, std::max(0.0, center - half_width), std::min(1.0, center + half_width)};
+}
+
+FilterSample sampleFilter(
+   const Database& database,
+   std::vector<OperatorResult>& bitmap_filter,
+   const Approximation& approximation
+) {
+   uint64_t population = 0;
+   for (const auto& filter : bitmap_filter) {
+      population += filter->cardinality();
+   }
+   // The deepest level of the row samples that still holds about sample_size of the filtered rows
+   uint32_t level = 0;
+   while ((population >> (level + 1)) >= approximation.sample_size) {
+      ++level;
+   }
+   if (level == 0) {
+      return {population, population};
+   }
+
+   std::vector<uint64_t> sample_size_per_partition(bitmap_filter.size());
+   tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, bitmap_filter.size()),
+      [&](const auto& local) {
+         for (size_t partition_id = local.begin(); partition_id != local.end(); ++partition_id) {
+            const roaring::Roaring& sampled_rows =
+               database.partitions[partition_id].row_sample.getLevel(level);
+            roaring::Roaring sample = *bitmap_filter[partition_id] & sampled_rows;
+            sample_size_per_partition[partition_id] = sample.cardinality();
+            bitmap_filter[partition_id] = OperatorResult(std::move(sample));
+         }
+      }
+   );
+
+   uint64_t sample_size = 0;
+   for (const uint64_t partition_sample_size : sample_size_per_partition) {
+      sample_size += partition_sample_size;
+   }
+   return {population, sample_size};
+}
+
+std::optional<Approximation> parseApproximation(
+   const nlohmann::json& json,
+   const std::string& action_name
+) {
+   if (!json.contains("approximate")) {
+      return std::nullopt;
+   }
+   const auto& approximate = json["approximate"];
+   if (approximate.is_boolean()) {
+      return approximate.get<bool>() ? std::optional<Approximation>{Approximation{}}
+                                     : std::nullopt;
+   }
+   CHECK_SILO_QUERY(
+      approximate.is_object() && approximate.contains("sampleSize") &&
+         approximate["sampleSize"].is_number_unsigned() &&
+         approximate["sampleSize"].get<uint64_t>() > 0 &&
+         approximate["sampleSize"].get<uint64_t>() <= UINT32_MAX,
+      "The field approximate of the " + action_name +
+         " action must be a boolean or an object {\"sampleSize\": number}, where sampleSize is "
+         "a positive 32 bit integer"
+   )
+   return Approximation{approximate["sampleSize"].get<uint32_t>()};
+}
+
+}  // namespace silo::query_engine::actions
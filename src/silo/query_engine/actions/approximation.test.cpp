@@ -0,0 +1,129 @@
+#include "silo/query_engine/actions/approximation.h"
+
+#include <gtest/gtest.h>
+#include <roaring/roaring.hh>
+
+#include "silo/database.h"
+#include "silo/query_engine/operator_result.h"
+#include "silo/storage/row_sample.h"
+
+using silo::query_engine::OperatorResult;
+using silo::query_engine::actions::Approximation;
+using silo::query_engine::actions::FilterSample;
+using silo::query_engine::actions::sampleFilter;
+
+namespace {
+
+constexpr uint32_t PARTITION_COUNT = 3;
+
+silo::Database createDatabase(uint32_t rows_per_partition) {
+   silo::Database database;
+   for (uint32_t partition_id = 0; partition_id < PARTITION_COUNT; ++partition_id) {
+      auto& partition =
+         database.partitions.emplace_back(std::vector<silo::preprocessing::PartitionChunk>{});
+      partition.sequence_count = rows_per_partition;
+      partition.row_sample = silo::storage::RowSample(partition_id, rows_per_partition);
+   }
+   return database;
+}
+
+std::vector<OperatorResult> createBitmapFilter(uint32_t rows_per_partition) {
+   std::vector<OperatorResult> bitmap_filter;
+   for (uint32_t partition_id = 0; partition_id < PARTITION_COUNT; ++partition_id) {
+      roaring::Roaring bitmap;
+      bitmap.addRange(0, rows_per_partition);
+      bitmap_filter.emplace_back(std::move(bitmap));
+   }
+   return bitmap_filter;
+}
+
+}  // namespace
+
+TEST(Approximation, keepsSmallFiltersExact) {
+   const auto database = createDatabase(10);
+   auto bitmap_filter = createBitmapFilter(10);
+   const FilterSample filter_sample = sampleFilter(database, bitmap_filter, Approximation{20});
+
+   EXPECT_TRUE(filter_sample.isExact());
+   EXPECT_EQ(filter_sample.population, 30);
+   EXPECT_EQ(bitmap_filter[0]->cardinality(), 10);
+   const auto estimate = filter_sample.estimateCount(7);
+   EXPECT_EQ(estimate.count, 7);
+   EXPECT_EQ(estimate.lower, 7);
+   EXPECT_EQ(estimate.upper, 7);
+}
+
+TEST(Approximation, samplesLargeFiltersDeterministically) {
+   const auto database = createDatabase(100'000);
+   auto bitmap_filter = createBitmapFilter(100'000);
+   auto other_bitmap_filter = createBitmapFilter(100'000);
+   const FilterSample filter_sample = sampleFilter(database, bitmap_filter, Approximation{3'000});
+   const FilterSample other_filter_sample =
+      sampleFilter(database, other_bitmap_filter, Approximation{3'000});
+
+   // 300'000 rows are sampled at the rate 2^-6, which keeps between 3'000 and 6'000 rows
+   EXPECT_FALSE(filter_sample.isExact());
+   EXPECT_EQ(filter_sample.population, 300'000);
+   EXPECT_NEAR(static_cast<double>(filter_sample.sample_size), 300'000.0 / 64, 300);
+   EXPECT_EQ(filter_sample.sample_size, other_filter_sample.sample_size);
+   for (size_t partition = 0; partition < bitmap_filter.size(); ++partition) {
+      EXPECT_EQ(*bitmap_filter[partition], *other_bitmap_filter[partition]);
+   }
+}
+
+TEST(Approximation, samplesOnlyFilteredRows) {
+   const auto database = createDatabase(100'000);
+   auto bitmap_filter = createBitmapFilter(100'000);
+   bitmap_filter[1] = OperatorResult(roaring::Roaring{});
+   roaring::Roaring first_half;
+   first_half.addRange(0, 50'000);
+   bitmap_filter[2] = OperatorResult(first_half);
+   const FilterSample filter_sample = sampleFilter(database, bitmap_filter, Approximation{1'000});
+
+   EXPECT_EQ(filter_sample.population, 150'000);
+   EXPECT_TRUE(bitmap_filter[1]->isEmpty());
+   EXPECT_TRUE(bitmap_filter[2]->isSubset(first_half));
+   EXPECT_EQ(
+      filter_sample.sample_size, bitmap_filter[0]->cardinality() + bitmap_filter[2]->cardinality()
+   );
+}
+
+TEST(RowSample, containsNestedLevelsOfHalvingSize) {
+   const silo::storage::RowSample row_sample(0, 1'000'000);
+
+   roaring::Roaring all_rows;
+   all_rows.addRange(0, 1'000'000);
+   const roaring::Roaring* previous_level = &all_rows;
+   for (uint32_t level = 1; level <= 8; ++level) {
+      const roaring::Roaring& rows = row_sample.getLevel(level);
+      EXPECT_TRUE(rows.isSubset(*previous_level));
+      EXPECT_NEAR(
+         static_cast<double>(rows.cardinality()),
+         static_cast<double>(previous_level->cardinality()) / 2,
+         static_cast<double>(previous_level->cardinality()) / 20
+      );
+      previous_level = &rows;
+   }
+   EXPECT_TRUE(row_sample.getLevel(64).isEmpty());
+}
+
+TEST(Approximation, scalesCountsWithConfidenceInterval) {
+   const FilterSample filter_sample{.population = 100'000, .sample_size = 1'000};
+
+   const auto estimate = filter_sample.estimateCount(100);
+   EXPECT_EQ(estimate.count, 10'000);
+   EXPECT_LT(estimate.lower, estimate.count);
+   EXPECT_GT(estimate.upper, estimate.count);
+   EXPECT_NEAR(static_cast<double>(estimate.lower), 8'290, 2);
+   EXPECT_NEAR(static_cast<double>(estimate.upper), 12'016, 2);
+
+   const auto none = filter_sample.estimateCount(0);
+   EXPECT_EQ(none.count, 0);
+   EXPECT_EQ(none.lower, 0);
+   EXPECT_GT(none.upper, 0);
+
+   const auto proportion = filter_sample.estimateProportion(100, 1'000);
+   EXPECT_DOUBLE_EQ(proportion.proportion, 0.1);
+   EXPECT_LT(proportion.lower, 0.1);
+   EXPECT_GT(proportion.upper, 0.1);
+}
@@ -0,0 +1,48 @@
+#include "silo/query_engine/actions/date_runs.h"
+
+#include <algorithm>
+
+#include "silo/preprocessing/partition.h"
+
+namespace silo::query_engine::actions {
+
+using common::DateTruncation;
+
+const std::map<std::string, DateTruncation> DATE_TRUNCATION_NAMES{
+   {"day", DateTruncation::DAY},
+   {"week", DateTruncation::WEEK},
+   {"month", DateTruncation::MONTH},
+   {"quarter", DateTruncation::QUARTER},
+   {"year", DateTruncation::YEAR},
+};
+
+std::vector<TruncatedDateRun> getTruncatedDateRuns(
+   const std::vector<common::Date>& dates,
+   const std::vector<preprocessing::PartitionChunk>& chunks,
+   DateTruncation truncation
+) {
+   std::vector<TruncatedDateRun> runs;
+   for (const auto& chunk : chunks) {
+      const auto chunk_end = dates.begin() + chunk.offset + chunk.size;
+      auto run_begin = dates.begin() + chunk.offset;
+      while (run_begin != chunk_end) {
+         const common::Date date = common::truncateDate(*run_begin, truncation);
+         const auto run_end = std::partition_point(run_begin, chunk_end, [&](common::Date value) {
+            return common::truncateDate(value, truncation) == date;
+         });
+         runs.push_back(
+            {date,
+             static_cast<uint32_t>(run_begin - dates.begin()),
+             static_cast<uint32_t>(run_end - dates.begin())}
+         );
+         run_begin = run_end;
+      }
+   }
+   return runs;
+}
+
+uint64_t countRowsInRange(const roaring::Roaring& rows, uint32_t begin, uint32_t end) {
+   return rows.rank(end - 1) - (begin == 0 ? 0 : rows.rank(begin - 1));
+}
+
+}  // namespace silo::query_engine::actions
@@ -1,22 +1,34 @@
 #include "silo/query_engine/actions/details.h"
 
 #include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <optional>
 #include <random>
 #include <ranges>
+#include <string_view>
+#include <tuple>
+#include <unordered_set>
 #include <utility>
+#include <variant>
 
 #include <oneapi/tbb/blocked_range.h>
 #include <oneapi/tbb/parallel_for.h>
 #include <nlohmann/json.hpp>
 
+#include "silo/common/date.h"
 #include "silo/config/database_config.h"
 #include "silo/database.h"
 #include "silo/query_engine/actions/action.h"
+#include "silo/query_engine/actions/normalized_sort_key.h"
 #include "silo/query_engine/actions/tuple.h"
 #include "silo/query_engine/operator_result.h"
 #include "silo/query_engine/query_parse_exception.h"
 #include "silo/query_engine/query_result.h"
 #include "silo/storage/column_group.h"
+#include "silo/storage/database_partition.h"
 
 namespace {
 
@@ -40,11 +52,127 @@ std::vector<silo::storage::ColumnMetadata> parseFields(
    return field_metadata;
 }
 
+constexpr std::string_view HEX_DIGITS = "0123456789abcdef";
+
+std::string toHex(const std::string& bytes) {
+   std::string hex;
+   hex.reserve(bytes.size() * 2);
+   for (const char byte : bytes) {
+      const auto value = static_cast<unsigned char>(byte);
+      hex.push_back(HEX_DIGITS[value >> 4]);
+      hex.push_back(HEX_DIGITS[value & 0xF]);
+   }
+   return hex;
+}
+
+std::optional<std::string> fromHex(const std::string& hex) {
+   if (hex.size() % 2 != 0) {
+      return std::nullopt;
+   }
+   std::string bytes;
+   bytes.reserve(hex.size() / 2);
+   for (size_t index = 0; index < hex.size(); index += 2) {
+      const size_t high = HEX_DIGITS.find(hex[index]);
+      const size_t low = HEX_DIGITS.find(hex[index + 1]);
+      if (high == std::string_view::npos || low == std::string_view::npos) {
+         return std::nullopt;
+      }
+      bytes.push_back(static_cast<char>((high << 4) | low));
+   }
+   return bytes;
+}
+
+/// FNV-1a, which in contrast to std::hash is stable across builds, such that tokens stay valid
+/// after a restart of the server
+uint64_t hashFilterExpression(const std::string& filter_expression) {
+   constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ULL;
+   constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+   uint64_t hash = FNV_OFFSET_BASIS;
+   for (const char character : filter_expression) {
+      hash ^= static_cast<unsigned char>(character);
+      hash *= FNV_PRIME;
+   }
+   return hash;
+}
+
+bool isSameOrder(
+   const std::vector<silo::query_engine::actions::OrderByField>& left,
+   const std::vector<silo::query_engine::actions::OrderByField>& right
+) {
+   return std::equal(
+      left.begin(),
+      left.end(),
+      right.begin(),
+      right.end(),
+      [](const auto& left_field, const auto& right_field) {
+         return left_field.name == right_field.name &&
+                left_field.ascending == right_field.ascending;
+      }
+   );
+}
+
 }  // namespace
 
 namespace silo::query_engine::actions {
-Details::Details(std::vector<std::string> fields)
-    : fields(std::move(fields)) {}
+Details::Details(
+   std::vector<std::string> fields,
+   std::optional<DetailsCursor> cursor,
+   std::optional<DetailsSample> sample
+)
+    : fields(std::move(fields)),
+      cursor(std::move(cursor)),
+      sample(sample) {}
+
+std::string DetailsCursor::toContinuationToken() const {
+   nlohmann::json order_by_json = nlohmann::json::array();
+   for (const OrderByField& field : order_by_fields) {
+      order_by_json.push_back({{"field", field.name}, {"ascending", field.ascending}});
+   }
+   const nlohmann::json json = {
+      {"dataVersion", data_version},
+      {"partition", partition_id},
+      {"row", row},
+      {"primaryKey", primary_key},
+      {"orderByFields", order_by_json},
+      {"filterHash", filter_hash}
+   };
+   return toHex(json.dump());
+}
+
+DetailsCursor DetailsCursor::fromContinuationToken(const std::string& continuation_token) {
+   const std::optional<std::string> decoded = fromHex(continuation_token);
+   const nlohmann::json json = decoded.has_value()
+                                  ? nlohmann::json::parse(decoded.value(), nullptr, false)
+                                  : nlohmann::json();
+   CHECK_SILO_QUERY(
+      json.is_object() && json.contains("dataVersion") && json["dataVersion"].is_string() &&
+         json.contains("partition") && json["partition"].is_number_unsigned() &&
+         json.contains("row") && json["row"].is_number_unsigned() &&
+         json.contains("primaryKey") && json["primaryKey"].is_string() &&
+         json.contains("orderByFields") && json["orderByFields"].is_array() &&
+         json.contains("filterHash") && json["filterHash"].is_number_unsigned(),
+      "The continuationToken '" + continuation_token + "' is invalid"
+   )
+   std::vector<OrderByField> order_by_fields;
+   for (const auto& field : json["orderByFields"]) {
+      CHECK_SILO_QUERY(
+         field.is_object() && field.contains("field") && field["field"].is_string() &&
+            field.contains("ascending") && field["ascending"].is_boolean(),
+         "The continuationToken '" + continuation_token + "' is invalid"
+      )
+      order_by_fields.push_back(
+         {.name = field["field"].get<std::string>(), .ascending = field["ascending"].get<bool>()}
+      );
+   }
+   return {
+      .data_version = json["dataVersion"].get<std::string>(),
+      .partition_id = json["partition"].get<uint32_t>(),
+      .row = json["row"].get<uint32_t>(),
+      .primary_key = json["primaryKey"].get<std::string>(),
+      .order_by_fields = std::move(order_by_fields),
+      .filter_hash = json["filterHash"].get<uint64_t>()
+   };
+}
 
 void Details::validateOrderByFields(const Database& database) const {
    const std::vector<silo::storage::ColumnMetadata> field_metadata = parseFields(database, fields);
@@ -70,26 +198,87 @@ QueryResult Details::execute(
    return QueryResult{};
 }
 
-std::vector<actions::Tuple> mergeSortedTuples(
-   const Tuple::Comparator& tuple_comparator,
-   std::vector<std::vector<actions::Tuple>>& tuples,
+/// A filtered row with the values of the fields that it is sorted by. The remaining fields are
+/// only materialized for the rows that are left after applying the offset and limit.
+template <typename SortKey>
+struct RowWithSortKey {
+   SortKey sort_key;
+   uint32_t partition_id;
+   uint32_t row;
+};
+
+template <typename SortKeyFactory>
+using SortKeyOf = decltype(std::declval<SortKeyFactory&>().allocateOne(0));
+
+/// Orders rows by their sort keys and rows with equal sort keys by their position in the
+/// database, such that the order is stable and a row can be used as the cursor of a page
+template <typename SortKeyComparator>
+class RowOrder {
+   const SortKeyComparator& sort_key_comparator;
+
+  public:
+   explicit RowOrder(const SortKeyComparator& sort_key_comparator)
+       : sort_key_comparator(sort_key_comparator) {}
+
+   template <typename SortKey>
+   bool comesBefore(
+      const SortKey& sort_key,
+      uint32_t partition_id,
+      uint32_t row,
+      const RowWithSortKey<SortKey>& other
+   ) const {
+      if (sort_key_comparator(sort_key, other.sort_key)) {
+         return true;
+      }
+      if (sort_key_comparator(other.sort_key, sort_key)) {
+         return false;
+      }
+      return std::tie(partition_id, row) < std::tie(other.partition_id, other.row);
+   }
+
+   template <typename SortKey>
+   bool comesAfter(
+      const SortKey& sort_key,
+      uint32_t partition_id,
+      uint32_t row,
+      const RowWithSortKey<SortKey>& other
+   ) const {
+      if (sort_key_comparator(other.sort_key, sort_key)) {
+         return true;
+      }
+      if (sort_key_comparator(sort_key, other.sort_key)) {
+         return false;
+      }
+      return std::tie(other.partition_id, other.row) < std::tie(partition_id, row);
+   }
+
+   template <typename SortKey>
+   bool operator()(const RowWithSortKey<SortKey>& lhs, const RowWithSortKey<SortKey>& rhs) const {
+      return comesBefore(lhs.sort_key, lhs.partition_id, lhs.row, rhs);
+   }
+};
+
+template <typename SortKey, typename RowComparator>
+std::vector<RowWithSortKey<SortKey>> mergeSortedRows(
+   const RowComparator& row_comparator,
+   std::vector<std::vector<RowWithSortKey<SortKey>>>& rows,
    const uint32_t to_produce
 ) {
-   using iterator = std::vector<actions::Tuple>::iterator;
+   using iterator = typename std::vector<RowWithSortKey<SortKey>>::iterator;
    std::vector<std::pair<iterator, iterator>> min_heap;
-   for (auto& tuple_vector : tuples) {
-      if (tuple_vector.begin() != tuple_vector.end()) {
-         min_heap.emplace_back(tuple_vector.begin(), tuple_vector.end());
+   for (auto& row_vector : rows) {
+      if (row_vector.begin() != row_vector.end()) {
+         min_heap.emplace_back(row_vector.begin(), row_vector.end());
       }
    }
 
    auto heap_cmp =
       [&](const std::pair<iterator, iterator>& lhs, const std::pair<iterator, iterator>& rhs) {
-         return tuple_comparator(*rhs.first, *lhs.first);
+         return row_comparator(*rhs.first, *lhs.first);
       };
    std::make_heap(min_heap.begin(), min_heap.end(), heap_cmp);
 
-   std::vector<actions::Tuple> result;
+   std::vector<RowWithSortKey<SortKey>> result;
 
    for (uint32_t counter = 0; counter < to_produce && !min_heap.empty(); counter++) {
       std::pop_heap(min_heap.begin(), min_heap.end(), heap_cmp);
@@ -105,60 +294,80 @@ std::vector<actions::Tuple> mergeSortedTuples(
    return result;
 }
 
-std::vector<actions::Tuple> produceSortedTuplesWithLimit(
-   std::vector<TupleFactory>& tuple_factories,
+template <typename SortKeyFactory, typename SortKeyComparator>
+std::vector<RowWithSortKey<SortKeyOf<SortKeyFactory>>> produceSortedRowsWithLimit(
+   std::vector<SortKeyFactory>& sort_key_factories,
    std::vector<OperatorResult>& bitmap_filter,
-   const Tuple::Comparator tuple_comparator,
+   const RowOrder<SortKeyComparator>& row_order,
+   const std::optional<RowWithSortKey<SortKeyOf<SortKeyFactory>>>& cursor,
    const uint32_t to_produce
 ) {
-   std::vector<std::vector<actions::Tuple>> tuples_per_partition(bitmap_filter.size());
+   using SortKey = SortKeyOf<SortKeyFactory>;
+   using Row = RowWithSortKey<SortKey>;
+   if (to_produce == 0) {
+      return {};
+   }
+   std::vector<std::vector<Row>> rows_per_partition(bitmap_filter.size());
    tbb::parallel_for(tbb::blocked_range<size_t>(0U, bitmap_filter.size()), [&](auto local) {
       for (size_t partition_id = local.begin(); partition_id != local.end(); partition_id++) {
          const auto& bitmap = bitmap_filter.at(partition_id);
-         TupleFactory& tuple_factory = tuple_factories.at(partition_id);
-         std::vector<actions::Tuple>& my_tuples = tuples_per_partition.at(partition_id);
+         SortKeyFactory& sort_key_factory = sort_key_factories.at(partition_id);
+         std::vector<Row>& my_rows = rows_per_partition.at(partition_id);
+         const auto is_after_cursor = [&](const SortKey& sort_key, uint32_t row) {
+            return !cursor.has_value() ||
+                   row_order.comesAfter(
+                      sort_key, static_cast<uint32_t>(partition_id), row, cursor.value()
+                   );
+         };
          const size_t result_size =
             std::min(bitmap->cardinality(), static_cast<uint64_t>(to_produce));
-         my_tuples = tuple_factory.allocateMany(result_size);
+         std::vector<SortKey> sort_keys = sort_key_factory.allocateMany(result_size);
+         my_rows.reserve(result_size);
          auto iterator = bitmap->begin();
          auto end = bitmap->end();
-         uint32_t counter = 0;
-         for (; iterator != end && counter < to_produce; iterator++) {
-            tuple_factory.overwrite(my_tuples.at(counter), *iterator);
-            counter++;
+         for (; iterator != end && my_rows.size() < to_produce; iterator++) {
+            SortKey& sort_key = sort_keys.at(my_rows.size());
+            sort_key_factory.overwrite(sort_key, *iterator);
+            if (is_after_cursor(sort_key, *iterator)) {
+               my_rows.push_back(
+                  {std::move(sort_key), static_cast<uint32_t>(partition_id), *iterator}
+               );
+            }
          }
 
          if (iterator != end) {
-            std::make_heap(my_tuples.begin(), my_tuples.end(), tuple_comparator);
-            Tuple current_tuple = tuple_factory.allocateOne(*iterator);
-            if (tuple_comparator(current_tuple, my_tuples.front())) {
-               std::pop_heap(my_tuples.begin(), my_tuples.end(), tuple_comparator);
-               my_tuples.back() = current_tuple;
-               std::push_heap(my_tuples.begin(), my_tuples.end(), tuple_comparator);
-            }
-            iterator++;
+            std::make_heap(my_rows.begin(), my_rows.end(), row_order);
+            SortKey current_sort_key = sort_key_factory.allocateOne(*iterator);
             for (; iterator != end; iterator++) {
-               tuple_factory.overwrite(current_tuple, *iterator);
-               if (tuple_comparator(current_tuple, my_tuples.front())) {
-                  std::pop_heap(my_tuples.begin(), my_tuples.end(), tuple_comparator);
-                  my_tuples.back() = current_tuple;
-                  std::push_heap(my_tuples.begin(), my_tuples.end(), tuple_comparator);
+               sort_key_factory.overwrite(current_sort_key, *iterator);
+               if (row_order.comesBefore(
+                      current_sort_key,
+                      static_cast<uint32_t>(partition_id),
+                      *iterator,
+                      my_rows.front()
+                   ) &&
+                   is_after_cursor(current_sort_key, *iterator)) {
+                  std::pop_heap(my_rows.begin(), my_rows.end(), row_order);
+                  my_rows.back().sort_key = current_sort_key;
+                  my_rows.back().row = *iterator;
+                  std::push_heap(my_rows.begin(), my_rows.end(), row_order);
                }
             }
-            std::sort_heap(my_tuples.begin(), my_tuples.end(), tuple_comparator);
+            std::sort_heap(my_rows.begin(), my_rows.end(), row_order);
          } else {
-            std::sort(my_tuples.begin(), my_tuples.end(), tuple_comparator);
+            std::sort(my_rows.begin(), my_rows.end(), row_order);
          }
       }
    });
-   return mergeSortedTuples(tuple_comparator, tuples_per_partition, to_produce);
+   return mergeSortedRows<SortKey>(row_order, rows_per_partition, to_produce);
 }
 
-std::vector<Tuple> produceAllTuples(
-   std::vector<TupleFactory>& tuple_factories,
+template <typename SortKeyFactory>
+std::vector<RowWithSortKey<SortKeyOf<SortKeyFactory>>> produceAllRows(
+   std::vector<SortKeyFactory>& sort_key_factories,
    std::vector<OperatorResult>& bitmap_filter
 ) {
-   if (tuple_factories.empty()) {
+   if (sort_key_factories.empty()) {
       return {};
    }
 
@@ -168,22 +377,432 @@ std::vector<Tuple> produceAllTuples(
          offsets[partition_id] + bitmap_filter.at(partition_id)->cardinality();
    }
 
-   std::vector<Tuple> all_tuples = tuple_factories.front().allocateMany(offsets.back());
+   std::vector<RowWithSortKey<SortKeyOf<SortKeyFactory>>> all_rows;
+   all_rows.reserve(offsets.back());
+   for (auto& sort_key : sort_key_factories.front().allocateMany(offsets.back())) {
+      all_rows.push_back({std::move(sort_key), 0, 0});
+   }
 
    tbb::parallel_for(tbb::blocked_range<size_t>(0U, bitmap_filter.size()), [&](auto local) {
       for (size_t partition_id = local.begin(); partition_id != local.end(); partition_id++) {
-         auto& tuple_factory = tuple_factories.at(partition_id);
+         auto& sort_key_factory = sort_key_factories.at(partition_id);
          const auto& bitmap = bitmap_filter.at(partition_id);
 
-         auto cursor = all_tuples.begin() +
-                       static_cast<decltype(all_tuples)::difference_type>(offsets.at(partition_id));
+         auto cursor = all_rows.begin() + static_cast<int64_t>(offsets.at(partition_id));
          for (const uint32_t sequence_id : *bitmap) {
-            tuple_factory.overwrite(*cursor, sequence_id);
+            sort_key_factory.overwrite(cursor->sort_key, sequence_id);
+            cursor->partition_id = partition_id;
+            cursor->row = sequence_id;
             cursor++;
          }
       }
    });
-   return all_tuples;
+   return all_rows;
+}
+
+/// Returns the filtered rows after the cursor in the order given by the comparator, restricted
+/// to the offset and limit
+template <typename SortKeyFactory, typename SortKeyComparator>
+std::vector<RowWithSortKey<SortKeyOf<SortKeyFactory>>> produceRowsInOrder(
+   std::vector<SortKeyFactory>& sort_key_factories,
+   std::vector<OperatorResult>& bitmap_filter,
+   const SortKeyComparator& sort_key_comparator,
+   const std::optional<DetailsCursor>& details_cursor,
+   bool is_ordered,
+   std::optional<uint32_t> limit,
+   std::optional<uint32_t> offset
+) {
+   using Row = RowWithSortKey<SortKeyOf<SortKeyFactory>>;
+   const RowOrder<SortKeyComparator> row_order(sort_key_comparator);
+   std::optional<Row> cursor;
+   if (details_cursor.has_value()) {
+      cursor = Row{
+         sort_key_factories.at(details_cursor->partition_id).allocateOne(details_cursor->row),
+         details_cursor->partition_id,
+         details_cursor->row
+      };
+   }
+
+   std::vector<Row> rows;
+   if (limit.has_value()) {
+      rows = produceSortedRowsWithLimit(
+         sort_key_factories, bitmap_filter, row_order, cursor, limit.value() + offset.value_or(0)
+      );
+   } else {
+      rows = produceAllRows(sort_key_factories, bitmap_filter);
+      if (cursor.has_value()) {
+         std::erase_if(rows, [&](const Row& row) {
+            return !row_order.comesAfter(row.sort_key, row.partition_id, row.row, cursor.value());
+         });
+      }
+      if (is_ordered) {
+         std::sort(rows.begin(), rows.end(), row_order);
+      }
+   }
+
+   const size_t end_of_rows = std::min(
+      static_cast<size_t>(limit.value_or(rows.size()) + offset.value_or(0UL)), rows.size()
+   );
+   rows.erase(rows.begin() + static_cast<int64_t>(end_of_rows), rows.end());
+   rows.erase(
+      rows.begin(),
+      rows.begin() + static_cast<int64_t>(std::min<size_t>(offset.value_or(0UL), rows.size()))
+   );
+   return rows;
+}
+
+/// Generates the requested fields of the rows, reading the columns of every partition in parallel
+template <typename SortKey>
+std::vector<QueryResultEntry> materializeRows(
+   const silo::Database& database,
+   const std::vector<storage::ColumnMetadata>& field_metadata,
+   const std::vector<RowWithSortKey<SortKey>>& rows
+) {
+   std::vector<std::vector<size_t>> result_indexes_per_partition(database.partitions.size());
+   for (size_t index = 0; index < rows.size(); ++index) {
+      result_indexes_per_partition.at(rows[index].partition_id).push_back(index);
+   }
+
+   std::vector<QueryResultEntry> result(rows.size());
+   tbb::parallel_for(tbb::blocked_range<size_t>(0U, database.partitions.size()), [&](auto local) {
+      for (size_t partition_id = local.begin(); partition_id != local.end(); partition_id++) {
+         const auto& result_indexes = result_indexes_per_partition.at(partition_id);
+         if (result_indexes.empty()) {
+            continue;
+         }
+         TupleFactory tuple_factory(database.partitions.at(partition_id).columns, field_metadata);
+         Tuple tuple = tuple_factory.allocateOne(rows[result_indexes.front()].row);
+         for (const size_t index : result_indexes) {
+            tuple_factory.overwrite(tuple, rows[index].row);
+            result[index] = {tuple.getFields()};
+         }
+      }
+   });
+   return result;
+}
+
+/// Returns the fields of the primary key of the row, serialized as JSON
+std::string readPrimaryKey(const silo::Database& database, uint32_t partition_id, uint32_t row) {
+   const auto& metadata =
+      database.database_config.getMetadata(database.database_config.schema.primary_key);
+   const std::vector<storage::ColumnMetadata> primary_key_metadata{
+      {metadata->name, metadata->getColumnType()}
+   };
+   TupleFactory tuple_factory(database.partitions.at(partition_id).columns, primary_key_metadata);
+   const Tuple tuple = tuple_factory.allocateOne(row);
+   return nlohmann::json(QueryResultEntry{tuple.getFields()}).dump();
+}
+
+/// Returns the continuation token of the page if it is full, because further rows may follow
+template <typename SortKey>
+std::optional<std::string> getContinuationToken(
+   const silo::Database& database,
+   const std::vector<RowWithSortKey<SortKey>>& rows,
+   std::optional<uint32_t> limit,
+   const std::vector<OrderByField>& order_by_fields,
+   uint64_t filter_hash
+) {
+   if (!limit.has_value() || limit.value() == 0 || rows.size() < limit.value()) {
+      return std::nullopt;
+   }
+   const auto& last_row = rows.back();
+   return DetailsCursor{
+      .data_version = database.getDataVersion().toString(),
+      .partition_id = last_row.partition_id,
+      .row = last_row.row,
+      .primary_key = readPrimaryKey(database, last_row.partition_id, last_row.row),
+      .order_by_fields = order_by_fields,
+      .filter_hash = filter_hash
+   }
+      .toContinuationToken();
+}
+
+/// The filtered rows of a chunk whose rows are sorted by date, visited in the order of the date
+/// and rows with equal dates in the order of their position. The rows are addressed by their rank
+/// in the filter, such that rows that are filtered out are never visited.
+class SortedChunkRows {
+   const roaring::Roaring* bitmap;
+   const common::Date* dates;
+   bool ascending;
+   uint32_t partition_id;
+   uint32_t chunk_begin;
+   uint32_t chunk_end;
+   uint32_t begin_rank;
+   /// The ranks that are left to visit are [next, run_end) and [begin_rank, remaining_end)
+   uint32_t remaining_end;
+   uint32_t next;
+   uint32_t run_end;
+   uint32_t current_row = 0;
+
+   /// The number of filtered rows before the row
+   [[nodiscard]] uint32_t rankBefore(uint32_t row) const {
+      return row == 0 ? 0 : static_cast<uint32_t>(bitmap->rank(row - 1));
+   }
+
+   void loadCurrentRow() {
+      if (next != run_end) {
+         bitmap->select(next, &current_row);
+      }
+   }
+
+   /// Descending dates are visited backwards in runs of equal dates, whose rows are visited
+   /// forwards
+   void loadNextRun() {
+      while (next == run_end && remaining_end != begin_rank) {
+         uint32_t last_row;
+         bitmap->select(remaining_end - 1, &last_row);
+         const uint32_t run_begin_row = static_cast<uint32_t>(
+            std::lower_bound(dates + chunk_begin, dates + last_row, dates[last_row]) - dates
+         );
+         next = rankBefore(run_begin_row);
+         run_end = remaining_end;
+         remaining_end = next;
+      }
+      loadCurrentRow();
+   }
+
+  public:
+   SortedChunkRows(
+      const roaring::Roaring& bitmap,
+      const common::Date* dates,
+      bool ascending,
+      uint32_t partition_id,
+      const preprocessing::PartitionChunk& chunk
+   )
+       : bitmap(&bitmap),
+         dates(dates),
+         ascending(ascending),
+         partition_id(partition_id),
+         chunk_begin(chunk.offset),
+         chunk_end(chunk.offset + chunk.size),
+         begin_rank(rankBefore(chunk_begin)),
+         remaining_end(rankBefore(chunk_end)),
+         next(remaining_end),
+         run_end(remaining_end) {
+      if (ascending) {
+         next = begin_rank;
+         remaining_end = begin_rank;
+      }
+      loadNextRun();
+   }
+
+   [[nodiscard]] bool isEmpty() const { return next == run_end; }
+
+   [[nodiscard]] RowWithSortKey<common::Date> getRow() const {
+      return {dates[current_row], partition_id, current_row};
+   }
+
+   void advance() {
+      ++next;
+      loadNextRun();
+   }
+
+   /// Skips the rows that come before the cursor or are the cursor
+   void skipUntilAfter(const RowWithSortKey<common::Date>& cursor) {
+      const uint32_t equal_begin = static_cast<uint32_t>(
+         std::lower_bound(dates + chunk_begin, dates + chunk_end, cursor.sort_key) - dates
+      );
+      const uint32_t equal_end = static_cast<uint32_t>(
+         std::upper_bound(dates + chunk_begin, dates + chunk_end, cursor.sort_key) - dates
+      );
+      uint32_t equal_after_cursor = equal_begin;
+      if (partition_id == cursor.partition_id) {
+         equal_after_cursor = std::clamp(cursor.row + 1, equal_begin, equal_end);
+      } else if (partition_id < cursor.partition_id) {
+         equal_after_cursor = equal_end;
+      }
+      if (ascending) {
+         next = std::max(next, rankBefore(equal_after_cursor));
+      } else {
+         next = rankBefore(equal_after_cursor);
+         run_end = rankBefore(equal_end);
+         remaining_end = rankBefore(equal_begin);
+      }
+      loadNextRun();
+   }
+};
+
+/// Whether the rows are only ordered by a date column that is sorted within the chunks of every
+/// partition, such that the order can be read from the chunks instead of sorting the rows
+bool isOrderedBySortedDate(
+   const silo::Database& database,
+   const std::vector<OrderByField>& order_by_fields
+) {
+   if (order_by_fields.size() != 1) {
+      return false;
+   }
+   const auto& metadata = database.database_config.getMetadata(order_by_fields.front().name);
+   if (!metadata.has_value() || metadata->getColumnType() != config::ColumnType::DATE) {
+      return false;
+   }
+   return std::all_of(
+      database.partitions.begin(),
+      database.partitions.end(),
+      [&](const DatabasePartition& partition) {
+         uint32_t chunk_rows = 0;
+         for (const auto& chunk : partition.getChunks()) {
+            chunk_rows += chunk.size;
+         }
+         return partition.columns.date_columns.at(metadata->name).isSorted() &&
+                chunk_rows == partition.sequence_count;
+      }
+   );
+}
+
+/// Merges the filtered rows of all chunks by their date, stopping after offset + limit rows
+std::vector<RowWithSortKey<common::Date>> produceRowsInDateOrder(
+   const silo::Database& database,
+   std::vector<OperatorResult>& bitmap_filter,
+   const OrderByField& date_field,
+   const std::optional<DetailsCursor>& details_cursor,
+   std::optional<uint32_t> limit,
+   std::optional<uint32_t> offset
+) {
+   std::optional<RowWithSortKey<common::Date>> cursor;
+   if (details_cursor.has_value()) {
+      const auto& cursor_dates = database.partitions.at(details_cursor->partition_id)
+                                    .columns.date_columns.at(date_field.name)
+                                    .getValues();
+      cursor = {
+         cursor_dates.at(details_cursor->row), details_cursor->partition_id, details_cursor->row
+      };
+   }
+
+   std::vector<SortedChunkRows> chunks;
+   for (uint32_t partition_id = 0; partition_id < database.partitions.size(); ++partition_id) {
+      const DatabasePartition& partition = database.partitions.at(partition_id);
+      const roaring::Roaring& bitmap = *bitmap_filter.at(partition_id);
+      if (bitmap.isEmpty()) {
+         continue;
+      }
+      const auto& dates = partition.columns.date_columns.at(date_field.name).getValues();
+      for (const auto& chunk : partition.getChunks()) {
+         if (chunk.size == 0) {
+            continue;
+         }
+         SortedChunkRows chunk_rows(
+            bitmap, dates.data(), date_field.ascending, partition_id, chunk
+         );
+         if (cursor.has_value()) {
+            chunk_rows.skipUntilAfter(cursor.value());
+         }
+         if (!chunk_rows.isEmpty()) {
+            chunks.push_back(chunk_rows);
+         }
+      }
+   }
+
+   const auto heap_cmp = [&](size_t left, size_t right) {
+      const auto left_row = chunks[left].getRow();
+      const auto right_row = chunks[right].getRow();
+      if (left_row.sort_key != right_row.sort_key) {
+         return date_field.ascending ? left_row.sort_key > right_row.sort_key
+                                     : left_row.sort_key < right_row.sort_key;
+      }
+      return std::tie(right_row.partition_id, right_row.row) <
+             std::tie(left_row.partition_id, left_row.row);
+   };
+   std::vector<size_t> min_heap(chunks.size());
+   std::iota(min_heap.begin(), min_heap.end(), 0);
+   std::make_heap(min_heap.begin(), min_heap.end(), heap_cmp);
+
+   const uint64_t to_produce =
+      limit.has_value() ? uint64_t{limit.value()} + offset.value_or(0) : UINT64_MAX;
+   std::vector<RowWithSortKey<common::Date>> rows;
+   while (rows.size() < to_produce && !min_heap.empty()) {
+      std::pop_heap(min_heap.begin(), min_heap.end(), heap_cmp);
+      SortedChunkRows& chunk_rows = chunks[min_heap.back()];
+      rows.push_back(chunk_rows.getRow());
+      chunk_rows.advance();
+      if (chunk_rows.isEmpty()) {
+         min_heap.pop_back();
+      } else {
+         std::push_heap(min_heap.begin(), min_heap.end(), heap_cmp);
+      }
+   }
+   rows.erase(
+      rows.begin(),
+      rows.begin() + static_cast<int64_t>(std::min<size_t>(offset.value_or(0UL), rows.size()))
+   );
+   return rows;
+}
+
+/// Draws the sample from all filtered rows, such that every partition contributes in proportion
+/// to its filter cardinality. The sampled rows are located by their rank in the filter with
+/// select, so that only they are visited. Returns the rows in the order of their position.
+std::vector<RowWithSortKey<std::monostate>> sampleRows(
+   const std::vector<OperatorResult>& bitmap_filter,
+   const DetailsSample& sample
+) {
+   std::vector<uint64_t> partition_ends;
+   partition_ends.reserve(bitmap_filter.size());
+   uint64_t total_count = 0;
+   for (const auto& filter : bitmap_filter) {
+      total_count += filter->cardinality();
+      partition_ends.push_back(total_count);
+   }
+
+   std::vector<uint64_t> ranks;
+   if (sample.size >= total_count) {
+      ranks.resize(total_count);
+      std::iota(ranks.begin(), ranks.end(), 0);
+   } else {
+      // Floyd's algorithm draws the distinct ranks with one random number each
+      std::mt19937_64 random_engine(sample.seed);
+      std::unordered_set<uint64_t> sampled_ranks;
+      sampled_ranks.reserve(sample.size);
+      for (uint64_t upper = total_count - sample.size; upper < total_count; ++upper) {
+         const uint64_t rank = std::uniform_int_distribution<uint64_t>(0, upper)(random_engine);
+         if (!sampled_ranks.insert(rank).second) {
+            sampled_ranks.insert(upper);
+         }
+      }
+      ranks.assign(sampled_ranks.begin(), sampled_ranks.end());
+      std::sort(ranks.begin(), ranks.end());
+   }
+
+   std::vector<RowWithSortKey<std::monostate>> rows;
+   rows.reserve(ranks.size());
+   uint32_t partition_id = 0;
+   for (const uint64_t rank : ranks) {
+      while (rank >= partition_ends[partition_id]) {
+         ++partition_id;
+      }
+      const uint64_t partition_begin = partition_id == 0 ? 0 : partition_ends[partition_id - 1];
+      uint32_t row;
+      bitmap_filter[partition_id]->select(static_cast<uint32_t>(rank - partition_begin), &row);
+      rows.push_back({.sort_key = {}, .partition_id = partition_id, .row = row});
+   }
+   return rows;
+}
+
+void Details::validateCursor(const Database& database) const {
+   if (!cursor.has_value()) {
+      return;
+   }
+   CHECK_SILO_QUERY(
+      !randomize_seed.has_value(), "A continuationToken cannot be combined with 'randomize'"
+   )
+   CHECK_SILO_QUERY(!sample.has_value(), "A continuationToken cannot be combined with 'sample'")
+   const std::string data_version = database.getDataVersion().toString();
+   CHECK_SILO_QUERY(
+      cursor->data_version == data_version,
+      "The continuationToken belongs to the data version " + cursor->data_version +
+         ", but the current data version is " + data_version +
+         ". The pagination has to be restarted."
+   )
+   CHECK_SILO_QUERY(
+      cursor->partition_id < database.partitions.size() &&
+         cursor->row < database.partitions.at(cursor->partition_id).sequence_count &&
+         cursor->primary_key == readPrimaryKey(database, cursor->partition_id, cursor->row),
+      "The continuationToken does not belong to this database"
+   )
+   CHECK_SILO_QUERY(
+      isSameOrder(cursor->order_by_fields, order_by_fields) &&
+         cursor->filter_hash == hashFilterExpression(filter_expression),
+      "The continuationToken belongs to a query with other orderByFields or another "
+      "filterExpression. The pagination has to be restarted."
+   )
 }
 
 QueryResult Details::executeAndOrder(
@@ -191,45 +810,128 @@ QueryResult Details::executeAndOrder(
    std::vector<OperatorResult> bitmap_filter
 ) const {
    validateOrderByFields(database);
+   validateCursor(database);
    const std::vector<storage::ColumnMetadata> field_metadata = parseFields(database, fields);
+   const uint64_t filter_hash = hashFilterExpression(filter_expression);
 
-   std::vector<TupleFactory> tuple_factories;
-   tuple_factories.reserve(database.partitions.size());
-   for (const auto& partition : database.partitions) {
-      tuple_factories.emplace_back(partition.columns, field_metadata);
+   // Only the sampled rows are materialized, the orderByFields, offset and limit apply to them
+   if (sample.has_value()) {
+      const auto rows = sampleRows(bitmap_filter, *sample);
+      QueryResult result{materializeRows(database, field_metadata, rows)};
+      applySort(result);
+      applyOffsetAndLimit(result);
+      return result;
    }
 
-   std::vector<actions::Tuple> tuples;
-   if (limit.has_value()) {
-      tuples = produceSortedTuplesWithLimit(
-         tuple_factories,
-         bitmap_filter,
-         Tuple::getComparator(field_metadata, order_by_fields, randomize_seed),
-         limit.value() + offset.value_or(0)
+   if (!randomize_seed.has_value() && isOrderedBySortedDate(database, order_by_fields)) {
+      const auto rows = produceRowsInDateOrder(
+         database, bitmap_filter, order_by_fields.front(), cursor, limit, offset
       );
-   } else {
-      tuples = produceAllTuples(tuple_factories, bitmap_filter);
-      if (!order_by_fields.empty() || randomize_seed) {
-         std::sort(
-            tuples.begin(),
-            tuples.end(),
-            Tuple::getComparator(field_metadata, order_by_fields, randomize_seed)
+      return QueryResult{
+         materializeRows(database, field_metadata, rows),
+         getContinuationToken(database, rows, limit, order_by_fields, filter_hash)
+      };
+   }
+
+   // Without randomization, rows are compared by integer keys into which the orderByFields are
+   // encoded, instead of comparing their tuples field by field
+   if (!randomize_seed.has_value()) {
+      const auto encoding = NormalizedSortKeyEncoding::create(database, order_by_fields);
+      if (encoding.has_value()) {
+         std::vector<NormalizedSortKeyFactory> sort_key_factories;
+         sort_key_factories.reserve(database.partitions.size());
+         for (const auto& partition : database.partitions) {
+            sort_key_factories.emplace_back(encoding.value(), partition.columns);
+         }
+         const auto rows = produceRowsInOrder(
+            sort_key_factories,
+            bitmap_filter,
+            std::less<NormalizedSortKey>{},
+            cursor,
+            !order_by_fields.empty(),
+            limit,
+            offset
          );
+         return QueryResult{
+            materializeRows(database, field_metadata, rows),
+            getContinuationToken(database, rows, limit, order_by_fields, filter_hash)
+         };
       }
    }
 
-   QueryResult results_in_format;
-   for (const auto& tuple : tuples) {
-      results_in_format.query_result.push_back({tuple.getFields()});
+   // Ties of a randomized order are broken by the hash of all fields, which are therefore all
+   // part of the sort key
+   std::vector<storage::ColumnMetadata> sort_key_metadata;
+   std::copy_if(
+      field_metadata.begin(),
+      field_metadata.end(),
+      std::back_inserter(sort_key_metadata),
+      [&](const storage::ColumnMetadata& metadata) {
+         return randomize_seed.has_value() ||
+                std::any_of(
+                   order_by_fields.begin(),
+                   order_by_fields.end(),
+                   [&](const OrderByField& field) { return field.name == metadata.name; }
+                );
+      }
+   );
+
+   std::vector<TupleFactory> sort_key_factories;
+   sort_key_factories.reserve(database.partitions.size());
+   for (const auto& partition : database.partitions) {
+      sort_key_factories.emplace_back(partition.columns, sort_key_metadata);
    }
-   applyOffsetAndLimit(results_in_format);
-   return results_in_format;
+
+   const auto rows = produceRowsInOrder(
+      sort_key_factories,
+      bitmap_filter,
+      Tuple::getComparator(sort_key_metadata, order_by_fields, randomize_seed),
+      cursor,
+      !order_by_fields.empty() || randomize_seed.has_value(),
+      limit,
+      offset
+   );
+
+   if (randomize_seed.has_value()) {
+      QueryResult results_in_format;
+      for (const auto& row : rows) {
+         results_in_format.query_result.push_back({row.sort_key.getFields()});
+      }
+      return results_in_format;
+   }
+   return QueryResult{
+      materializeRows(database, field_metadata, rows),
+      getContinuationToken(database, rows, limit, order_by_fields, filter_hash)
+   };
 }
 
 // NOLINTNEXTLINE(readability-identifier-naming)
 void from_json(const nlohmann::json& json, std::unique_ptr<Details>& action) {
    const std::vector<std::string> fields = json.value("fields", std::vector<std::string>());
-   action = std::make_unique<Details>(fields);
+   std::optional<DetailsCursor> cursor;
+   if (json.contains("continuationToken")) {
+      CHECK_SILO_QUERY(
+         json["continuationToken"].is_string(),
+         "The continuationToken of the Details action must be a string"
+      )
+      cursor = DetailsCursor::fromContinuationToken(json["continuationToken"].get<std::string>());
+   }
+   std::optional<DetailsSample> sample;
+   if (json.contains("sample")) {
+      CHECK_SILO_QUERY(
+         json["sample"].is_object() && json["sample"].contains("size") &&
+            json["sample"]["size"].is_number_unsigned() &&
+            (!json["sample"].contains("seed") || json["sample"]["seed"].is_number_unsigned()),
+         "The sample of the Details action must be an object containing an unsigned 'size' and "
+         "optionally an unsigned 'seed'"
+      )
+      const uint32_t seed =
+         json["sample"].contains("seed")
+            ? json["sample"]["seed"].get<uint32_t>()
+            : static_cast<uint32_t>(std::chrono::system_clock::now().time_since_epoch().count());
+      sample = DetailsSample{.size = json["sample"]["size"].get<uint32_t>(), .seed = seed};
+   }
+   action = std::make_unique<Details>(fields, std::move(cursor), sample);
 }
 
 }  // namespace silo::query_engine::actions
@@ -0,0 +1,169 @@
+#include "silo/query_engine/actions/diversity.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include "silo/common/aa_symbols.h"
+#include "silo/common/nucleotide_symbols.h"
+#include "silo/common/symbol_map.h"
+#include "silo/database.h"
+#include "silo/query_engine/actions/action.h"
+#include "silo/query_engine/actions/symbol_counts.h"
+#include "silo/query_engine/operator_result.h"
+#include "silo/query_engine/query_parse_exception.h"
+#include "silo/query_engine/query_result.h"
+#include "silo/storage/sequence_store.h"
+
+using silo::query_engine::OperatorResult;
+
+namespace silo::query_engine::actions {
+
+template <typename SymbolType>
+Diversity<SymbolType>::Diversity(std::vector<std::string>&& sequence_names, double min_entropy)
+    : sequence_names(std::move(sequence_names)),
+      min_entropy(min_entropy) {}
+
+template <typename SymbolType>
+void Diversity<SymbolType>::validateOrderByFields(const Database& /*database*/) const {
+   const std::vector<std::string> result_field_names{
+      {POSITION_FIELD_NAME, SEQUENCE_FIELD_NAME, ENTROPY_FIELD_NAME, COVERAGE_FIELD_NAME}
+   };
+
+   for (const OrderByField& field : order_by_fields) {
+      CHECK_SILO_QUERY(
+         std::any_of(
+            result_field_names.begin(),
+            result_field_names.end(),
+            [&](const std::string& result_field) { return result_field == field.name; }
+         ),
+         fmt::format(
+            "OrderByField {} is not contained in the result of this operation. "
+            "Allowed values are {}.",
+            field.name,
+            fmt::join(result_field_names, ", ")
+         )
+      )
+   }
+}
+
+template <typename SymbolType>
+QueryResult Diversity<SymbolType>::execute(
+   const Database& database,
+   std::vector<OperatorResult> bitmap_filter
+) const {
+   std::vector<std::string> sequence_names_to_evaluate;
+   for (const auto& sequence_name : sequence_names) {
+      CHECK_SILO_QUERY(
+         database.getSequenceStores<SymbolType>().contains(sequence_name),
+         "Database does not contain the " + std::string(SymbolType::SYMBOL_NAME_LOWER_CASE) +
+            " sequence with name: '" + sequence_name + "'"
+      )
+      sequence_names_to_evaluate.emplace_back(sequence_name);
+   }
+   if (sequence_names.empty()) {
+      for (const auto& [sequence_name, _] : database.getSequenceStores<SymbolType>()) {
+         sequence_names_to_evaluate.emplace_back(sequence_name);
+      }
+   }
+
+   const auto bitmaps_to_evaluate = preFilterBitmaps<SymbolType>(database, bitmap_filter);
+
+   std::vector<QueryResultEntry> diversity;
+   for (const auto& sequence_name : sequence_names_to_evaluate) {
+      if (!bitmaps_to_evaluate.contains(sequence_name)) {
+         continue;
+      }
+      const SequenceStore<SymbolType>& sequence_store =
+         database.getSequenceStores<SymbolType>().at(sequence_name);
+      const SymbolMap<SymbolType, std::vector<uint32_t>> symbol_counts_per_position =
+         calculateMutationsPerPosition(sequence_store, bitmaps_to_evaluate.at(sequence_name));
+
+      const size_t sequence_length = sequence_store.reference_sequence.size();
+      for (size_t pos = 0; pos < sequence_length; ++pos) {
+         uint32_t coverage = 0;
+         for (const typename SymbolType::Symbol symbol : SymbolType::VALID_MUTATION_SYMBOLS) {
+            coverage += symbol_counts_per_position.at(symbol)[pos];
+         }
+         if (coverage == 0) {
+            continue;
+         }
+         double entropy = 0;
+         for (const typename SymbolType::Symbol symbol : SymbolType::VALID_MUTATION_SYMBOLS) {
+            const uint32_t count = symbol_counts_per_position.at(symbol)[pos];
+            if (count > 0) {
+               const double proportion = static_cast<double>(count) / coverage;
+               entropy -= proportion * std::log2(proportion);
+            }
+         }
+         // Avoid -0.0 for positions with a single symbol
+         entropy = std::max(entropy, 0.0);
+         if (entropy < min_entropy) {
+            continue;
+         }
+         const std::map<std::string, common::JsonValueType> fields{
+            {POSITION_FIELD_NAME, static_cast<int32_t>(pos + 1)},
+            {SEQUENCE_FIELD_NAME, sequence_name},
+            {ENTROPY_FIELD_NAME, entropy},
+            {COVERAGE_FIELD_NAME, static_cast<int32_t>(coverage)}
+         };
+         diversity.push_back({fields});
+      }
+   }
+   return {diversity};
+}
+
+template <typename SymbolType>
+// NOLINTNEXTLINE(readability-identifier-naming)
+void from_json(const nlohmann::json& json, std::unique_ptr<Diversity<SymbolType>>& action) {
+   CHECK_SILO_QUERY(
+      !json.contains("sequenceName") ||
+         (json["sequenceName"].is_string() || json["sequenceName"].is_array()),
+      "Diversity action can have the field sequenceName of type string or an array of "
+      "strings, but no other type"
+   )
+   std::vector<std::string> sequence_names;
+   if (json.contains("sequenceName") && json["sequenceName"].is_array()) {
+      for (const auto& child : json["sequenceName"]) {
+         CHECK_SILO_QUERY(
+            child.is_string(),
+            "The field sequenceName of Diversity action must have type string or an "
+            "array, if present. Found:" +
+               child.dump()
+         )
+         sequence_names.emplace_back(child.get<std::string>());
+      }
+   } else if (json.contains("sequenceName") && json["sequenceName"].is_string()) {
+      sequence_names.emplace_back(json["sequenceName"].get<std::string>());
+   }
+
+   CHECK_SILO_QUERY(
+      !json.contains("minEntropy") ||
+         (json["minEntropy"].is_number() && json["minEntropy"].get<double>() >= 0),
+      "The field minEntropy of the Diversity action must be a non-negative number"
+   )
+   const double min_entropy = json.value("minEntropy", 0.0);
+
+   action = std::make_unique<Diversity<SymbolType>>(std::move(sequence_names), min_entropy);
+}
+
+template class Diversity<AminoAcid>;
+template class Diversity<Nucleotide>;
+// NOLINTNEXTLINE(readability-identifier-naming)
+template void from_json<AminoAcid>(
+   const nlohmann::json& json,
+   std::unique_ptr<Diversity<AminoAcid>>& action
+);
+// NOLINTNEXTLINE(readability-identifier-naming)
+template void from_json<Nucleotide>(
+   const nlohmann::json& json,
+   std::unique_ptr<Diversity<Nucleotide>>& action
+);
+
+}  // namespace silo::query_engine::actions
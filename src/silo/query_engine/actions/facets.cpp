@@ -0,0 +1,246 @@
+#include "silo/query_engine/actions/facets.h"
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <nlohmann/json.hpp>
+#include <roaring/roaring.hh>
+
+#include "silo/common/types.h"
+#include "silo/config/database_config.h"
+#include "silo/database.h"
+#include "silo/query_engine/actions/action.h"
+#include "silo/query_engine/actions/indexed_column.h"
+#include "silo/query_engine/actions/tuple.h"
+#include "silo/query_engine/actions/tuple_map.h"
+#include "silo/query_engine/operator_result.h"
+#include "silo/query_engine/query_parse_exception.h"
+#include "silo/query_engine/query_result.h"
+#include "silo/storage/column_group.h"
+#include "silo/storage/database_partition.h"
+
+namespace silo::query_engine::actions {
+
+namespace {
+
+struct FacetValue {
+   common::JsonValueType value;
+   uint64_t count;
+};
+
+using ValueIdCounts = std::unordered_map<Idx, uint64_t>;
+
+}  // namespace
+
+Facets::Facets(std::vector<std::string> fields, std::optional<uint32_t> limit_per_facet)
+    : fields(std::move(fields)),
+      limit_per_facet(limit_per_facet) {}
+
+void Facets::validateOrderByFields(const Database& /*database*/) const {
+   const std::vector<std::string> result_field_names{
+      {FIELD_FIELD_NAME, VALUE_FIELD_NAME, COUNT_FIELD_NAME}
+   };
+
+   for (const OrderByField& field : order_by_fields) {
+      CHECK_SILO_QUERY(
+         std::any_of(
+            result_field_names.begin(),
+            result_field_names.end(),
+            [&](const std::string& result_field) { return result_field == field.name; }
+         ),
+         fmt::format(
+            "OrderByField {} is not contained in the result of this operation. "
+            "Allowed values are {}.",
+            field.name,
+            fmt::join(result_field_names, ", ")
+         )
+      )
+   }
+}
+
+QueryResult Facets::execute(const Database& database, std::vector<OperatorResult> bitmap_filter)
+   const {
+   std::vector<storage::ColumnMetadata> indexed_metadata;
+   std::vector<storage::ColumnMetadata> other_metadata;
+   for (const std::string& field : fields) {
+      const auto& metadata = database.database_config.getMetadata(field);
+      CHECK_SILO_QUERY(
+         metadata.has_value(), "Metadata field '" + field + "' of the Facets action not found"
+      )
+      const config::ColumnType column_type = metadata->getColumnType();
+      CHECK_SILO_QUERY(
+         column_type != config::ColumnType::NUC_INSERTION &&
+            column_type != config::ColumnType::AA_INSERTION,
+         "The Facets action cannot count the values of the insertion field '" + field + "'"
+      )
+      const storage::ColumnMetadata column_metadata{metadata->name, column_type};
+      if (isIndexedColumn(column_metadata)) {
+         indexed_metadata.push_back(column_metadata);
+      } else {
+         other_metadata.push_back(column_metadata);
+      }
+   }
+   if (database.partitions.empty()) {
+      return {};
+   }
+
+   // The maps of the other fields point into the tuple factories, which must not move anymore
+   std::vector<std::vector<TupleFactory>> tuple_factories_per_partition(database.partitions.size());
+   for (size_t partition_id = 0; partition_id < database.partitions.size(); ++partition_id) {
+      auto& tuple_factories = tuple_factories_per_partition[partition_id];
+      tuple_factories.reserve(other_metadata.size());
+      for (const auto& metadata : other_metadata) {
+         tuple_factories.emplace_back(
+            database.partitions[partition_id].columns,
+            std::vector<storage::ColumnMetadata>{metadata}
+         );
+      }
+   }
+   std::vector<std::vector<TupleCountMap>> tuple_maps_per_field(other_metadata.size());
+   for (size_t field_index = 0; field_index < other_metadata.size(); ++field_index) {
+      for (const auto& tuple_factories : tuple_factories_per_partition) {
+         tuple_maps_per_field[field_index].emplace_back(tuple_factories[field_index]);
+      }
+   }
+   std::vector<std::vector<IndexedValueCounts>> indexed_counts_per_partition(
+      database.partitions.size(), std::vector<IndexedValueCounts>(indexed_metadata.size())
+   );
+
+   tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, database.partitions.size()),
+      [&](const tbb::blocked_range<size_t>& range) {
+         for (size_t partition_id = range.begin(); partition_id != range.end(); ++partition_id) {
+            const DatabasePartition& partition = database.partitions[partition_id];
+            const roaring::Roaring& rows = *bitmap_filter[partition_id];
+            if (rows.isEmpty()) {
+               continue;
+            }
+            const bool rows_are_full_partition = rows.cardinality() == partition.sequence_count;
+            for (size_t field_index = 0; field_index < indexed_metadata.size(); ++field_index) {
+               countIndexedValues(
+                  getIndexedColumn(partition.columns, indexed_metadata[field_index]),
+                  rows,
+                  rows_are_full_partition,
+                  0,
+                  indexed_counts_per_partition[partition_id][field_index]
+               );
+            }
+            if (other_metadata.empty()) {
+               continue;
+            }
+            // One scan over the rows counts the values of all fields that are not indexed
+            auto& tuple_factories = tuple_factories_per_partition[partition_id];
+            std::vector<Tuple> tuples;
+            tuples.reserve(other_metadata.size());
+            for (auto& tuple_factory : tuple_factories) {
+               tuples.push_back(tuple_factory.allocateOne(rows.minimum()));
+            }
+            for (const uint32_t row : rows) {
+               for (size_t field_index = 0; field_index < other_metadata.size(); ++field_index) {
+                  const Tuple& tuple =
+                     tuple_factories[field_index].overwrite(tuples[field_index], row);
+                  ++tuple_maps_per_field[field_index][partition_id][tuple];
+               }
+            }
+         }
+      }
+   );
+
+   std::map<std::string, std::vector<FacetValue>> values_per_field;
+   const storage::ColumnPartitionGroup& columns = database.partitions.front().columns;
+   for (size_t field_index = 0; field_index < indexed_metadata.size(); ++field_index) {
+      ValueIdCounts final_counts;
+      for (const auto& counts : indexed_counts_per_partition) {
+         for (const auto& [key, count] : counts[field_index]) {
+            final_counts[static_cast<Idx>(key)] += count;
+         }
+      }
+      const auto& metadata = indexed_metadata[field_index];
+      auto& values = values_per_field[metadata.name];
+      for (const auto& [value_id, count] : final_counts) {
+         values.push_back({lookupIndexedValue(columns, metadata, value_id), count});
+      }
+   }
+   for (size_t field_index = 0; field_index < other_metadata.size(); ++field_index) {
+      TupleCountMap final_map = TupleCountMap::merge(
+         tuple_factories_per_partition.front()[field_index], tuple_maps_per_field[field_index]
+      );
+      const std::string& name = other_metadata[field_index].name;
+      auto& values = values_per_field[name];
+      for (uint32_t radix_partition = 0; radix_partition < TupleCountMap::RADIX_PARTITION_COUNT;
+           ++radix_partition) {
+         final_map.forEachInRadixPartition(
+            radix_partition,
+            [&](const Tuple& tuple, uint32_t& count) {
+               values.push_back({tuple.getFields().at(name), count});
+            }
+         );
+      }
+   }
+
+   std::vector<QueryResultEntry> result;
+   for (const std::string& field : fields) {
+      auto& values = values_per_field.at(field);
+      const auto comes_before = [](const FacetValue& left, const FacetValue& right) {
+         return left.count != right.count ? left.count > right.count : left.value < right.value;
+      };
+      if (limit_per_facet.has_value() && values.size() > *limit_per_facet) {
+         std::partial_sort(
+            values.begin(), values.begin() + *limit_per_facet, values.end(), comes_before
+         );
+         values.resize(*limit_per_facet);
+      } else {
+         std::sort(values.begin(), values.end(), comes_before);
+      }
+      for (auto& [value, count] : values) {
+         const std::map<std::string, common::JsonValueType> entry_fields{
+            {FIELD_FIELD_NAME, field},
+            {VALUE_FIELD_NAME, std::move(value)},
+            {COUNT_FIELD_NAME, static_cast<int32_t>(count)}
+         };
+         result.push_back({entry_fields});
+      }
+   }
+   return {result};
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void from_json(const nlohmann::json& json, std::unique_ptr<Facets>& action) {
+   CHECK_SILO_QUERY(
+      json.contains("fields") && json["fields"].is_array() && !json["fields"].empty(),
+      "Facets action must contain the field fields of type non-empty array of strings"
+   )
+   std::vector<std::string> fields;
+   for (const auto& child : json["fields"]) {
+      CHECK_SILO_QUERY(
+         child.is_string(),
+         "The field fields of the Facets action must be an array of strings. Found:" + child.dump()
+      )
+      const auto field = child.get<std::string>();
+      CHECK_SILO_QUERY(
+         std::find(fields.begin(), fields.end(), field) == fields.end(),
+         "The field '" + field + "' is contained more than once in the fields of the Facets action"
+      )
+      fields.push_back(field);
+   }
+
+   CHECK_SILO_QUERY(
+      !json.contains("limitPerFacet") ||
+         (json["limitPerFacet"].is_number_unsigned() && json["limitPerFacet"].get<uint32_t>() > 0),
+      "If the Facets action contains a limitPerFacet, it must be a positive number"
+   )
+   std::optional<uint32_t> limit_per_facet;
+   if (json.contains("limitPerFacet")) {
+      limit_per_facet = json["limitPerFacet"].get<uint32_t>();
+   }
+
+   action = std::make_unique<Facets>(std::move(fields), limit_per_facet);
+}
+
+}  // namespace silo::query_engine::actions
@@ -1,14 +1,23 @@
 #include "silo/query_engine/actions/fasta.h"
 
+#include <algorithm>
+#include <iterator>
+#include <memory>
+
 #include <fmt/format.h>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
 #include <spdlog/spdlog.h>
 #include <duckdb.hpp>
 #include <nlohmann/json.hpp>
 
 #include "silo/database.h"
+#include "silo/query_engine/actions/row_chunks.h"
 #include "silo/query_engine/operator_result.h"
 #include "silo/query_engine/query_parse_exception.h"
 #include "silo/query_engine/query_result.h"
+#include "silo/storage/unaligned_sequence_store.h"
+#include "silo/zstdfasta/zstd_decompressor.h"
 #include "silo/zstdfasta/zstdfasta_table_reader.h"
 
 namespace silo {
@@ -17,6 +26,8 @@ class Database;
 
 namespace {
 
+constexpr size_t DECOMPRESSION_BATCH_SIZE = 64;
+
 std::unique_ptr<duckdb::MaterializedQueryResult> query(
    duckdb::Connection& connection,
    std::string sql_query
@@ -84,7 +95,7 @@ std::string getTableQuery(
    }
 
    std::string duckdb_table_query = fmt::format(
-      "SELECT key_table.key {} FROM {} key_table {} WHERE TRUE {}",
+      "SELECT key_table.key {}, key_table.row_index FROM {} key_table {} WHERE TRUE {}",
       select_clause,
       key_table_name,
       table_clause,
@@ -94,12 +105,11 @@ std::string getTableQuery(
 }
 
 void addSequencesFromResultTableToJson(
-   QueryResult& results,
+   std::vector<QueryResultEntry>& entries,
    duckdb::Connection& connection,
    const std::string& result_table_name,
    const std::vector<std::string>& sequence_names,
-   const DatabasePartition& database_partition,
-   size_t number_of_values
+   const DatabasePartition& database_partition
 ) {
    for (size_t sequence_idx = 0; sequence_idx < sequence_names.size(); sequence_idx++) {
       const std::string& sequence_name = sequence_names.at(sequence_idx);
@@ -111,43 +121,92 @@ void addSequencesFromResultTableToJson(
          compression_dict,
          fmt::format("t{}_sequence", sequence_idx),
          "TRUE",
-         "ORDER BY key"
+         "ORDER BY row_index"
       );
       table_reader.loadTable();
       std::optional<std::string> genome_buffer;
 
-      const size_t start_of_partition_in_result = results.query_result.size() - number_of_values;
-      const size_t end_of_partition_in_result = results.query_result.size();
-      for (size_t idx = start_of_partition_in_result; idx < end_of_partition_in_result; idx++) {
+      for (auto& entry : entries) {
          auto current_key = table_reader.next(genome_buffer);
          assert(current_key.has_value());
          if (genome_buffer.has_value()) {
-            results.query_result.at(idx).fields.emplace(sequence_name, *genome_buffer);
+            entry.fields.emplace(sequence_name, *genome_buffer);
          } else {
-            results.query_result.at(idx).fields.emplace(sequence_name, std::nullopt);
+            entry.fields.emplace(sequence_name, std::nullopt);
          }
       }
    }
 }
 
-}  // namespace
+/// Reads the sequences of the rows directly from the row index of the unaligned sequence stores,
+/// decompressing batches of rows in parallel
+void addSequencesFromRowIndex(
+   std::vector<QueryResultEntry>& entries,
+   const std::vector<uint32_t>& row_ids,
+   const std::vector<std::string>& sequence_names,
+   const DatabasePartition& database_partition
+) {
+   tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, row_ids.size(), DECOMPRESSION_BATCH_SIZE),
+      [&](const auto& local) {
+         for (const std::string& sequence_name : sequence_names) {
+            const auto& sequence_store =
+               database_partition.unaligned_nuc_sequences.at(sequence_name);
+            silo::ZstdDecompressor decompressor(sequence_store.compression_dictionary);
+            for (size_t idx = local.begin(); idx != local.end(); ++idx) {
+               const auto compressed = sequence_store.getCompressedSequence(row_ids[idx]);
+               if (compressed.has_value()) {
+                  entries[idx].fields.emplace(
+                     sequence_name,
+                     std::string(decompressor.decompress(compressed->data(), compressed->size()))
+                  );
+               } else {
+                  entries[idx].fields.emplace(sequence_name, std::nullopt);
+               }
+            }
+         }
+      }
+   );
+}
 
-void Fasta::addSequencesToResultsForPartition(
-   QueryResult& results,
+/// Appends an entry with the primary key and the unaligned sequences of every row to entries
+void addSequencesToResults(
+   std::vector<QueryResultEntry>& entries,
+   duckdb::DuckDB& duck_db,
+   const std::vector<std::string>& sequence_names,
    const DatabasePartition& database_partition,
-   const OperatorResult& bitmap,
+   const std::vector<uint32_t>& row_ids,
    const std::string& primary_key_column
-) const {
-   duckdb::DuckDB duck_db;
-   duckdb::Connection connection(duck_db);
+) {
+   if (row_ids.empty()) {
+      SPDLOG_TRACE("Skipping empty partition!");
+      return;
+   }
 
-   const size_t number_of_values = bitmap->cardinality();
+   entries.reserve(row_ids.size());
+   for (const uint32_t sequence_id : row_ids) {
+      auto primary_key = database_partition.columns.getValue(primary_key_column, sequence_id);
+      if (primary_key == std::nullopt) {
+         throw std::runtime_error(
+            fmt::format("Detected primary_key in column '{}' that is null.", primary_key_column)
+         );
+      }
+      QueryResultEntry entry;
+      entry.fields.emplace(primary_key_column, primary_key.value());
+      entries.emplace_back(std::move(entry));
+   }
 
-   if (bitmap->isEmpty()) {
-      SPDLOG_TRACE("Skipping empty partition!");
+   const bool has_row_index =
+      std::all_of(sequence_names.begin(), sequence_names.end(), [&](const auto& sequence_name) {
+         return database_partition.unaligned_nuc_sequences.at(sequence_name).hasRowIndex();
+      });
+   if (has_row_index) {
+      addSequencesFromRowIndex(entries, row_ids, sequence_names, database_partition);
       return;
    }
 
+   duckdb::Connection connection(duck_db);
+
    uint64_t unique_identifier_for_function = unique_identifier++;
    std::string key_table_name = fmt::format("tmp_fasta_key_{}", unique_identifier_for_function);
    std::string result_table_name = fmt::format("tmp_result_{}", unique_identifier_for_function);
@@ -155,8 +214,9 @@ void Fasta::addSequencesToResultsForPartition(
    (void)query(
       connection,
       fmt::format(
-         "CREATE TABLE {} ("
-         "    key STRING"
+         "CREATE TEMPORARY TABLE {} ("
+         "    key STRING,"
+         "    row_index UINTEGER"
          ");",
          key_table_name
       )
@@ -164,34 +224,15 @@ void Fasta::addSequencesToResultsForPartition(
    SPDLOG_TRACE("Created temporary duckdb table for holding keys");
 
    duckdb::Appender appender(connection, key_table_name);
-
-   for (const uint32_t sequence_id : *bitmap) {
+   for (uint32_t row_index = 0; row_index < entries.size(); ++row_index) {
       appender.BeginRow();
-      auto primary_key = database_partition.columns.getValue(primary_key_column, sequence_id);
-      if (primary_key == std::nullopt) {
-         throw std::runtime_error(
-            fmt::format("Detected primary_key in column '{}' that is null.", primary_key_column)
-         );
-      }
-      std::string primary_key_string;
-      if (holds_alternative<double>(primary_key.value())) {
-         primary_key_string = std::to_string(get<double>(primary_key.value()));
-      } else if (holds_alternative<int32_t>(primary_key.value())) {
-         primary_key_string = std::to_string(get<int32_t>(primary_key.value()));
-      } else {
-         assert(holds_alternative<std::string>(primary_key.value()));
-         primary_key_string = get<std::string>(primary_key.value());
-      }
-      appender.Append(duckdb::Value::BLOB(primary_key_string));
-
-      // Also add the key to the entries for later
-      QueryResultEntry entry;
-      entry.fields.emplace(primary_key_column, primary_key.value());
-      results.query_result.emplace_back(std::move(entry));
-
+      appender.Append(duckdb::Value::BLOB(
+         primaryKeyToString(entries[row_index].fields.at(primary_key_column).value())
+      ));
+      appender.Append(row_index);
       appender.EndRow();
-      appender.Flush();
    }
+   // The appender flushes its buffered rows in bulk when it is closed
    appender.Close();
 
    const std::string table_query =
@@ -199,27 +240,36 @@ void Fasta::addSequencesToResultsForPartition(
 
    SPDLOG_TRACE(
       "Create table query for unaligned in-memory sequence tables: {}",
-      fmt::format("CREATE TABLE {} AS ({})", result_table_name, table_query)
+      fmt::format("CREATE TEMPORARY TABLE {} AS ({})", result_table_name, table_query)
    );
 
-   (void)query(connection, fmt::format("CREATE TABLE {} AS ({})", result_table_name, table_query));
+   (void)query(
+      connection,
+      fmt::format("CREATE TEMPORARY TABLE {} AS ({})", result_table_name, table_query)
+   );
 
    addSequencesFromResultTableToJson(
-      results, connection, result_table_name, sequence_names, database_partition, number_of_values
+      entries, connection, result_table_name, sequence_names, database_partition
    );
 
    (void)query(connection, fmt::format("DROP TABLE {};", result_table_name));
    (void)query(connection, fmt::format("DROP TABLE {};", key_table_name));
 }
 
-QueryResult Fasta::execute(const Database& database, std::vector<OperatorResult> bitmap_filter)
-   const {
+}  // namespace
+
+void Fasta::validateSequenceNames(const Database& database) const {
    for (const std::string& sequence_name : sequence_names) {
       CHECK_SILO_QUERY(
          database.unaligned_nuc_sequences.contains(sequence_name),
          "Database does not contain an unaligned sequence with name: '" + sequence_name + "'"
       )
    }
+}
+
+QueryResult Fasta::execute(const Database& database, std::vector<OperatorResult> bitmap_filter)
+   const {
+   validateSequenceNames(database);
 
    const std::string& primary_key_column = database.database_config.schema.primary_key;
 
@@ -229,21 +279,77 @@ QueryResult Fasta::execute(const Database& database, std::vector<OperatorResult>
    }
    CHECK_SILO_QUERY(
       total_count <= SEQUENCE_LIMIT,
-      fmt::format("Fasta action currently limited to {} sequences", SEQUENCE_LIMIT)
+      fmt::format(
+         "Fasta action with orderByFields or randomize currently limited to {} sequences",
+         SEQUENCE_LIMIT
+      )
+   );
+
+   std::vector<std::vector<QueryResultEntry>> entries_per_partition(database.partitions.size());
+   tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, database.partitions.size()),
+      [&](const auto& local) {
+         for (size_t partition_index = local.begin(); partition_index != local.end();
+              ++partition_index) {
+            const auto& bitmap = bitmap_filter[partition_index];
+            std::vector<uint32_t> row_ids(bitmap->cardinality());
+            bitmap->toUint32Array(row_ids.data());
+            addSequencesToResults(
+               entries_per_partition[partition_index],
+               *database.unaligned_sequences_duckdb,
+               sequence_names,
+               database.partitions[partition_index],
+               row_ids,
+               primary_key_column
+            );
+         }
+      }
    );
 
    QueryResult results;
    results.query_result.reserve(total_count);
+   for (auto& entries : entries_per_partition) {
+      std::move(entries.begin(), entries.end(), std::back_inserter(results.query_result));
+   }
 
-   for (uint32_t partition_index = 0; partition_index < database.partitions.size();
-        ++partition_index) {
-      const auto& database_partition = database.partitions[partition_index];
-      const auto& bitmap = bitmap_filter[partition_index];
+   return results;
+}
 
-      addSequencesToResultsForPartition(results, database_partition, bitmap, primary_key_column);
+QueryResult Fasta::executeAndOrder(
+   const Database& database,
+   std::vector<OperatorResult> bitmap_filter
+) const {
+   if (!order_by_fields.empty() || randomize_seed.has_value()) {
+      return Action::executeAndOrder(database, std::move(bitmap_filter));
    }
+   validateSequenceNames(database);
 
-   return results;
+   auto row_chunks = std::make_shared<RowChunks>(
+      std::move(bitmap_filter), offset.value_or(0), limit, STREAMING_CHUNK_SIZE
+   );
+
+   QueryResult result;
+   result.streamed_entry_count = row_chunks->remainingCount();
+   // The action does not outlive the query execution, so the stream holds copies of its fields
+   result.next_chunk = [&database,
+                        row_chunks,
+                        sequence_names = sequence_names,
+                        primary_key_column = database.database_config.schema.primary_key]() {
+      std::vector<QueryResultEntry> entries;
+      const auto chunk = row_chunks->next();
+      if (chunk.has_value()) {
+         addSequencesToResults(
+            entries,
+            *database.unaligned_sequences_duckdb,
+            sequence_names,
+            database.partitions.at(chunk->partition_id),
+            chunk->row_ids,
+            primary_key_column
+         );
+      }
+      return entries;
+   };
+   return result;
 }
 
 // NOLINTNEXTLINE(readability-identifier-naming)
@@ -1,6 +1,10 @@
 #include "silo/query_engine/actions/fasta_aligned.h"
 
+#include <algorithm>
+#include <iterator>
+#include <limits>
 #include <map>
+#include <memory>
 #include <optional>
 #include <utility>
 
@@ -15,6 +19,7 @@
 #include "silo/config/database_config.h"
 #include "silo/database.h"
 #include "silo/query_engine/actions/action.h"
+#include "silo/query_engine/actions/row_chunks.h"
 #include "silo/query_engine/operator_result.h"
 #include "silo/query_engine/query_parse_exception.h"
 #include "silo/query_engine/query_result.h"
@@ -22,8 +27,12 @@
 
 namespace silo::query_engine::actions {
 
-FastaAligned::FastaAligned(std::vector<std::string>&& sequence_names)
-    : sequence_names(sequence_names) {}
+FastaAligned::FastaAligned(
+   std::vector<std::string>&& sequence_names,
+   bool differences_to_reference
+)
+    : sequence_names(sequence_names),
+      differences_to_reference(differences_to_reference) {}
 
 void FastaAligned::validateOrderByFields(const Database& database) const {
    const std::string& primary_key_field = database.database_config.schema.primary_key;
@@ -43,23 +52,35 @@ void FastaAligned::validateOrderByFields(const Database& database) const {
    }
 }
 
+namespace {
+
+/// Reconstructs the sequences of all rows at once. The sequences are filled with the reference
+/// and only the symbol bitmaps that intersect the rows are iterated, so the cost is proportional
+/// to the number of differences to the reference rather than to the length of the genome.
+/// row_ids need to be sorted.
 template <typename SymbolType>
-std::string reconstructSequence(
+std::vector<std::string> reconstructSequences(
    const SequenceStorePartition<SymbolType>& sequence_store,
-   uint32_t sequence_id
+   const std::vector<uint32_t>& row_ids
 ) {
-   std::string reconstructed_sequence;
+   std::string default_sequence;
+   default_sequence.reserve(sequence_store.reference_sequence.size());
    std::transform(
       sequence_store.reference_sequence.begin(),
       sequence_store.reference_sequence.end(),
-      std::back_inserter(reconstructed_sequence),
+      std::back_inserter(default_sequence),
       SymbolType::symbolToChar
    );
-
    for (const auto& [position_id, symbol] :
         sequence_store.indexing_differences_to_reference_sequence) {
-      reconstructed_sequence[position_id] = SymbolType::symbolToChar(symbol);
+      default_sequence[position_id] = SymbolType::symbolToChar(symbol);
+   }
+
+   std::vector<std::string> reconstructed_sequences(row_ids.size(), default_sequence);
+   if (row_ids.empty()) {
+      return reconstructed_sequences;
    }
+   const roaring::Roaring row_bitmap(row_ids.size(), row_ids.data());
 
    tbb::parallel_for(
       tbb::blocked_range<size_t>(0, sequence_store.positions.size()),
@@ -67,28 +88,192 @@ std::string reconstructSequence(
          for (auto position_id = local.begin(); position_id != local.end(); position_id++) {
             const Position<SymbolType>& position = sequence_store.positions.at(position_id);
             for (const auto symbol : SymbolType::SYMBOLS) {
-               if (!position.isSymbolFlipped(symbol) && !position.isSymbolDeleted(symbol)
-                   && position.getBitmap(symbol)->contains(sequence_id)) {
-                  reconstructed_sequence[position_id] = SymbolType::symbolToChar(symbol);
+               if (position.isSymbolFlipped(symbol) || position.isSymbolDeleted(symbol)) {
+                  continue;
+               }
+               const roaring::Roaring& symbol_bitmap = *position.getBitmap(symbol);
+               if (!symbol_bitmap.intersect(row_bitmap)) {
+                  continue;
+               }
+               const char symbol_char = SymbolType::symbolToChar(symbol);
+               for (const uint32_t row_id : symbol_bitmap & row_bitmap) {
+                  const auto row_index =
+                     std::lower_bound(row_ids.begin(), row_ids.end(), row_id) - row_ids.begin();
+                  reconstructed_sequences[row_index][position_id] = symbol_char;
                }
             }
          }
       }
    );
 
-   for (const size_t position_idx : sequence_store.missing_symbol_bitmaps.at(sequence_id)) {
-      reconstructed_sequence[position_idx] = SymbolType::symbolToChar(SymbolType::SYMBOL_MISSING);
+   for (size_t row_index = 0; row_index < row_ids.size(); ++row_index) {
+      for (const uint32_t position_idx :
+           sequence_store.missing_symbol_bitmaps.at(row_ids[row_index])) {
+         reconstructed_sequences[row_index][position_idx] =
+            SymbolType::symbolToChar(SymbolType::SYMBOL_MISSING);
+      }
    }
-   return reconstructed_sequence;
+   return reconstructed_sequences;
 }
 
-QueryResult FastaAligned::execute(
+/// Describes the sequences of all rows by their differences to the reference, as a comma
+/// separated list in position order. Substitutions are written like mutations (e.g. C241T) and
+/// runs of missing symbols as their 1-based position range (e.g. 1-54). row_ids need to be sorted.
+template <typename SymbolType>
+std::vector<std::string> differencesToReference(
+   const SequenceStorePartition<SymbolType>& sequence_store,
+   const std::vector<uint32_t>& row_ids
+) {
+   using Substitution = std::pair<uint32_t, typename SymbolType::Symbol>;
+   std::vector<std::vector<Substitution>> stored_symbols_per_row(row_ids.size());
+   if (!row_ids.empty()) {
+      const roaring::Roaring row_bitmap(row_ids.size(), row_ids.data());
+      for (uint32_t position_id = 0; position_id < sequence_store.positions.size();
+           ++position_id) {
+         const Position<SymbolType>& position = sequence_store.positions[position_id];
+         for (const auto symbol : SymbolType::SYMBOLS) {
+            if (position.isSymbolFlipped(symbol) || position.isSymbolDeleted(symbol)) {
+               continue;
+            }
+            const roaring::Roaring& symbol_bitmap = *position.getBitmap(symbol);
+            if (!symbol_bitmap.intersect(row_bitmap)) {
+               continue;
+            }
+            for (const uint32_t row_id : symbol_bitmap & row_bitmap) {
+               const auto row_index =
+                  std::lower_bound(row_ids.begin(), row_ids.end(), row_id) - row_ids.begin();
+               stored_symbols_per_row[row_index].emplace_back(position_id, symbol);
+            }
+         }
+      }
+   }
+
+   std::vector<Substitution> default_differences;
+   for (const auto& [position_id, symbol] :
+        sequence_store.indexing_differences_to_reference_sequence) {
+      default_differences.emplace_back(position_id, symbol);
+   }
+   std::sort(default_differences.begin(), default_differences.end());
+
+   const auto format_substitution = [&](const Substitution& substitution) {
+      return fmt::format(
+         "{}{}{}",
+         SymbolType::symbolToChar(sequence_store.reference_sequence.at(substitution.first)),
+         substitution.first + 1,
+         SymbolType::symbolToChar(substitution.second)
+      );
+   };
+
+   std::vector<std::string> differences(row_ids.size());
+   for (size_t row_index = 0; row_index < row_ids.size(); ++row_index) {
+      const auto& stored_symbols = stored_symbols_per_row[row_index];
+
+      // Rows that are in no bitmap of a position have the default symbol of that position
+      std::vector<Substitution> substitutions;
+      auto stored_it = stored_symbols.begin();
+      auto default_it = default_differences.begin();
+      while (stored_it != stored_symbols.end() || default_it != default_differences.end()) {
+         if (default_it == default_differences.end() ||
+             (stored_it != stored_symbols.end() && stored_it->first <= default_it->first)) {
+            if (default_it != default_differences.end() && stored_it->first == default_it->first) {
+               ++default_it;
+            }
+            if (sequence_store.reference_sequence.at(stored_it->first) != stored_it->second) {
+               substitutions.emplace_back(*stored_it);
+            }
+            ++stored_it;
+         } else {
+            substitutions.emplace_back(*default_it);
+            ++default_it;
+         }
+      }
+
+      std::vector<std::string> parts;
+      auto substitution_it = substitutions.begin();
+      const auto add_substitutions_before = [&](uint32_t position_id) {
+         for (; substitution_it != substitutions.end() && substitution_it->first < position_id;
+              ++substitution_it) {
+            parts.emplace_back(format_substitution(*substitution_it));
+         }
+      };
+      const auto add_missing_range = [&](uint32_t start, uint32_t end) {
+         add_substitutions_before(start);
+         while (substitution_it != substitutions.end() && substitution_it->first <= end) {
+            ++substitution_it;
+         }
+         parts.emplace_back(fmt::format("{}-{}", start + 1, end + 1));
+      };
+
+      std::optional<std::pair<uint32_t, uint32_t>> missing_range;
+      for (const uint32_t position_id :
+           sequence_store.missing_symbol_bitmaps.at(row_ids[row_index])) {
+         if (missing_range.has_value() && missing_range->second + 1 == position_id) {
+            missing_range->second = position_id;
+            continue;
+         }
+         if (missing_range.has_value()) {
+            add_missing_range(missing_range->first, missing_range->second);
+         }
+         missing_range = {position_id, position_id};
+      }
+      if (missing_range.has_value()) {
+         add_missing_range(missing_range->first, missing_range->second);
+      }
+      add_substitutions_before(std::numeric_limits<uint32_t>::max());
+
+      differences[row_index] = fmt::format("{}", fmt::join(parts, ","));
+   }
+   return differences;
+}
+
+void addSequencesToResults(
+   std::vector<QueryResultEntry>& entries,
+   const DatabasePartition& database_partition,
+   const std::vector<uint32_t>& row_ids,
+   const std::vector<std::string>& nuc_sequence_names,
+   const std::vector<std::string>& aa_sequence_names,
+   const std::string& primary_key_column,
+   bool differences_to_reference
+) {
+   const size_t first_entry = entries.size();
+   entries.resize(first_entry + row_ids.size());
+   for (size_t row_index = 0; row_index < row_ids.size(); ++row_index) {
+      entries[first_entry + row_index].fields.emplace(
+         primary_key_column,
+         database_partition.columns.getValue(primary_key_column, row_ids[row_index])
+      );
+   }
+   for (const auto& nuc_sequence_name : nuc_sequence_names) {
+      const auto& sequence_store = database_partition.nuc_sequences.at(nuc_sequence_name);
+      auto sequences = differences_to_reference
+                          ? differencesToReference<Nucleotide>(sequence_store, row_ids)
+                          : reconstructSequences<Nucleotide>(sequence_store, row_ids);
+      for (size_t row_index = 0; row_index < row_ids.size(); ++row_index) {
+         entries[first_entry + row_index].fields.emplace(
+            nuc_sequence_name, std::move(sequences[row_index])
+         );
+      }
+   }
+   for (const auto& aa_sequence_name : aa_sequence_names) {
+      const auto& aa_store = database_partition.aa_sequences.at(aa_sequence_name);
+      auto sequences = differences_to_reference
+                          ? differencesToReference<AminoAcid>(aa_store, row_ids)
+                          : reconstructSequences<AminoAcid>(aa_store, row_ids);
+      for (size_t row_index = 0; row_index < row_ids.size(); ++row_index) {
+         entries[first_entry + row_index].fields.emplace(
+            aa_sequence_name, std::move(sequences[row_index])
+         );
+      }
+   }
+}
+
+}  // namespace
+
+void FastaAligned::splitSequenceNames(
    const Database& database,
-   std::vector<OperatorResult> bitmap_filter
+   std::vector<std::string>& nuc_sequence_names,
+   std::vector<std::string>& aa_sequence_names
 ) const {
-   std::vector<std::string> nuc_sequence_names;
-   std::vector<std::string> aa_sequence_names;
-
    for (const std::string& sequence_name : sequence_names) {
       CHECK_SILO_QUERY(
          database.nuc_sequences.contains(sequence_name) ||
@@ -101,42 +286,90 @@ QueryResult FastaAligned::execute(
          aa_sequence_names.emplace_back(sequence_name);
       }
    }
+}
+
+QueryResult FastaAligned::execute(
+   const Database& database,
+   std::vector<OperatorResult> bitmap_filter
+) const {
+   std::vector<std::string> nuc_sequence_names;
+   std::vector<std::string> aa_sequence_names;
+   splitSequenceNames(database, nuc_sequence_names, aa_sequence_names);
 
    size_t total_count = 0;
    for (auto& filter : bitmap_filter) {
       total_count += filter->cardinality();
    }
-   CHECK_SILO_QUERY(total_count < 10001, "FastaAligned action currently limited to 10000 sequences")
+   CHECK_SILO_QUERY(
+      total_count <= SEQUENCE_LIMIT,
+      fmt::format(
+         "FastaAligned action with orderByFields or randomize currently limited to {} sequences",
+         SEQUENCE_LIMIT
+      )
+   )
 
+   const std::string& primary_key_column = database.database_config.schema.primary_key;
    QueryResult results;
    for (uint32_t partition_index = 0; partition_index < database.partitions.size();
         ++partition_index) {
-      const auto& database_partition = database.partitions[partition_index];
       const auto& bitmap = bitmap_filter[partition_index];
-      for (const uint32_t sequence_id : *bitmap) {
-         QueryResultEntry entry;
-         const std::string primary_key_column = database.database_config.schema.primary_key;
-         entry.fields.emplace(
-            primary_key_column, database_partition.columns.getValue(primary_key_column, sequence_id)
-         );
-         for (const auto& nuc_sequence_name : nuc_sequence_names) {
-            const auto& sequence_store = database_partition.nuc_sequences.at(nuc_sequence_name);
-            entry.fields.emplace(
-               nuc_sequence_name, reconstructSequence<Nucleotide>(sequence_store, sequence_id)
-            );
-         }
-         for (const auto& aa_sequence_name : aa_sequence_names) {
-            const auto& aa_store = database_partition.aa_sequences.at(aa_sequence_name);
-            entry.fields.emplace(
-               aa_sequence_name, reconstructSequence<AminoAcid>(aa_store, sequence_id)
-            );
-         }
-         results.query_result.emplace_back(entry);
-      }
+      std::vector<uint32_t> row_ids(bitmap->cardinality());
+      bitmap->toUint32Array(row_ids.data());
+      addSequencesToResults(
+         results.query_result,
+         database.partitions[partition_index],
+         row_ids,
+         nuc_sequence_names,
+         aa_sequence_names,
+         primary_key_column,
+         differences_to_reference
+      );
    }
    return results;
 }
 
+QueryResult FastaAligned::executeAndOrder(
+   const Database& database,
+   std::vector<OperatorResult> bitmap_filter
+) const {
+   if (!order_by_fields.empty() || randomize_seed.has_value()) {
+      return Action::executeAndOrder(database, std::move(bitmap_filter));
+   }
+   std::vector<std::string> nuc_sequence_names;
+   std::vector<std::string> aa_sequence_names;
+   splitSequenceNames(database, nuc_sequence_names, aa_sequence_names);
+
+   auto row_chunks = std::make_shared<RowChunks>(
+      std::move(bitmap_filter), offset.value_or(0), limit, STREAMING_CHUNK_SIZE
+   );
+
+   QueryResult result;
+   result.streamed_entry_count = row_chunks->remainingCount();
+   // The action does not outlive the query execution, so the stream holds copies of its fields
+   result.next_chunk = [&database,
+                        row_chunks,
+                        nuc_sequence_names = std::move(nuc_sequence_names),
+                        aa_sequence_names = std::move(aa_sequence_names),
+                        primary_key_column = database.database_config.schema.primary_key,
+                        differences_to_reference = differences_to_reference]() {
+      std::vector<QueryResultEntry> entries;
+      const auto chunk = row_chunks->next();
+      if (chunk.has_value()) {
+         addSequencesToResults(
+            entries,
+            database.partitions.at(chunk->partition_id),
+            chunk->row_ids,
+            nuc_sequence_names,
+            aa_sequence_names,
+            primary_key_column,
+            differences_to_reference
+         );
+      }
+      return entries;
+   };
+   return result;
+}
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 void from_json(const nlohmann::json& json, std::unique_ptr<FastaAligned>& action) {
    CHECK_SILO_QUERY(
@@ -159,7 +392,12 @@ void from_json(const nlohmann::json& json, std::unique_ptr<FastaAligned>& action
    } else {
       sequence_names.emplace_back(json["sequenceName"].get<std::string>());
    }
-   action = std::make_unique<FastaAligned>(std::move(sequence_names));
+   CHECK_SILO_QUERY(
+      !json.contains("differencesToReference") || json["differencesToReference"].is_boolean(),
+      "The field differencesToReference in a FastaAligned action must be a boolean"
+   )
+   const bool differences_to_reference = json.value("differencesToReference", false);
+   action = std::make_unique<FastaAligned>(std::move(sequence_names), differences_to_reference);
 }
 
 }  // namespace silo::query_engine::actions
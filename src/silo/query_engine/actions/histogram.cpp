@@ -0,0 +1,315 @@
+#include "silo/query_engine/actions/histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <optional>
+#include <utility>
+
+#include <fmt/format.h>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <nlohmann/json.hpp>
+#include <roaring/roaring.hh>
+
+#include "silo/common/date.h"
+#include "silo/config/database_config.h"
+#include "silo/database.h"
+#include "silo/query_engine/actions/action.h"
+#include "silo/query_engine/actions/numeric_column.h"
+#include "silo/query_engine/operator_result.h"
+#include "silo/query_engine/query_parse_exception.h"
+#include "silo/query_engine/query_result.h"
+#include "silo/storage/database_partition.h"
+
+namespace silo::query_engine::actions {
+
+namespace {
+
+using silo::config::ColumnType;
+
+struct ValueRange {
+   double min = std::numeric_limits<double>::infinity();
+   double max = -std::numeric_limits<double>::infinity();
+};
+
+ValueRange getValueRange(
+   const Database& database,
+   const storage::ColumnMetadata& metadata,
+   const std::vector<OperatorResult>& bitmap_filter
+) {
+   std::vector<ValueRange> range_per_partition(database.partitions.size());
+   tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, database.partitions.size()),
+      [&](const tbb::blocked_range<size_t>& local) {
+         for (size_t partition_id = local.begin(); partition_id != local.end(); ++partition_id) {
+            const NumericColumn column(database.partitions[partition_id].columns, metadata);
+            auto& range = range_per_partition[partition_id];
+            for (const uint32_t row : *bitmap_filter[partition_id]) {
+               const auto value = column.getValue(row);
+               if (value.has_value()) {
+                  range.min = std::min(range.min, *value);
+                  range.max = std::max(range.max, *value);
+               }
+            }
+         }
+      }
+   );
+   ValueRange range;
+   for (const auto& partition_range : range_per_partition) {
+      range.min = std::min(range.min, partition_range.min);
+      range.max = std::max(range.max, partition_range.max);
+   }
+   return range;
+}
+
+/// INT and DATE buckets have an integral width, so that every bucket holds the same number of
+/// distinct values
+std::vector<double> getEqualWidthBoundaries(
+   const ValueRange& range,
+   ColumnType column_type,
+   uint32_t bucket_count
+) {
+   std::vector<double> boundaries;
+   if (column_type == ColumnType::FLOAT) {
+      if (range.min == range.max) {
+         return {range.min, range.max};
+      }
+      const double width = (range.max - range.min) / bucket_count;
+      for (uint32_t bucket = 0; bucket < bucket_count; ++bucket) {
+         boundaries.push_back(range.min + bucket * width);
+      }
+      boundaries.push_back(range.max);
+      return boundaries;
+   }
+   const double distinct_values = range.max - range.min + 1;
+   const double width = std::ceil(distinct_values / bucket_count);
+   const auto used_bucket_count = static_cast<uint32_t>(std::ceil(distinct_values / width));
+   for (uint32_t bucket = 0; bucket <= used_bucket_count; ++bucket) {
+      boundaries.push_back(range.min + bucket * width);
+   }
+   return boundaries;
+}
+
+std::vector<double> parseBoundaries(
+   const std::vector<std::variant<double, std::string>>& bucket_boundaries,
+   const storage::ColumnMetadata& metadata
+) {
+   std::vector<double> boundaries;
+   for (const auto& boundary : bucket_boundaries) {
+      if (metadata.type == ColumnType::DATE) {
+         CHECK_SILO_QUERY(
+            std::holds_alternative<std::string>(boundary),
+            "The bucketBoundaries of the Histogram action for the date field '" + metadata.name +
+               "' must be dates of the form 'YYYY-MM-DD'"
+         )
+         const common::Date date = common::stringToDate(std::get<std::string>(boundary));
+         CHECK_SILO_QUERY(
+            date != common::NULL_DATE,
+            "The bucket boundary '" + std::get<std::string>(boundary) +
+               "' of the Histogram action is not a valid date"
+         )
+         boundaries.push_back(common::dateToDays(date));
+      } else {
+         CHECK_SILO_QUERY(
+            std::holds_alternative<double>(boundary),
+            "The bucketBoundaries of the Histogram action for the field '" + metadata.name +
+               "' must be numbers"
+         )
+         const double value = std::get<double>(boundary);
+         // Fractional boundaries would be reported truncated for int fields
+         CHECK_SILO_QUERY(
+            metadata.type != ColumnType::INT || std::trunc(value) == value,
+            "The bucketBoundaries of the Histogram action for the int field '" + metadata.name +
+               "' must be integers"
+         )
+         boundaries.push_back(value);
+      }
+      CHECK_SILO_QUERY(
+         boundaries.size() == 1 || boundaries[boundaries.size() - 2] < boundaries.back(),
+         "The bucketBoundaries of the Histogram action must be strictly increasing"
+      )
+   }
+   return boundaries;
+}
+
+/// The number of buckets between the boundaries. Without boundaries, i.e. if all values are
+/// null, there are no buckets.
+size_t getBucketCount(const std::vector<double>& boundaries) {
+   return boundaries.empty() ? 0 : boundaries.size() - 1;
+}
+
+/// The bucket counts of the rows of one partition, followed by the count of null values
+std::vector<uint64_t> countBuckets(
+   const NumericColumn& column,
+   const roaring::Roaring& rows,
+   const std::vector<double>& boundaries,
+   bool last_bucket_contains_upper_bound
+) {
+   const size_t bucket_count = getBucketCount(boundaries);
+   std::vector<uint64_t> counts(bucket_count + 1);
+   for (const uint32_t row : rows) {
+      const auto value = column.getValue(row);
+      if (!value.has_value()) {
+         ++counts[bucket_count];
+         continue;
+      }
+      const auto upper = std::upper_bound(boundaries.begin(), boundaries.end(), *value);
+      if (upper == boundaries.begin()) {
+         continue;
+      }
+      if (upper != boundaries.end()) {
+         ++counts[upper - boundaries.begin() - 1];
+      } else if (last_bucket_contains_upper_bound && *value == boundaries.back()) {
+         ++counts[bucket_count - 1];
+      }
+   }
+   return counts;
+}
+
+}  // namespace
+
+Histogram::Histogram(
+   std::string field,
+   uint32_t bucket_count,
+   std::vector<std::variant<double, std::string>> bucket_boundaries
+)
+    : field(std::move(field)),
+      bucket_count(bucket_count),
+      bucket_boundaries(std::move(bucket_boundaries)) {}
+
+void Histogram::validateOrderByFields(const Database& /*database*/) const {
+   const std::vector<std::string> result_field_names{
+      {LOWER_BOUND_FIELD_NAME, UPPER_BOUND_FIELD_NAME, COUNT_FIELD_NAME}
+   };
+
+   for (const OrderByField& field : order_by_fields) {
+      CHECK_SILO_QUERY(
+         std::any_of(
+            result_field_names.begin(),
+            result_field_names.end(),
+            [&](const std::string& result_field) { return result_field == field.name; }
+         ),
+         fmt::format(
+            "OrderByField {} is not contained in the result of this operation. "
+            "Allowed values are {}.",
+            field.name,
+            fmt::join(result_field_names, ", ")
+         )
+      )
+   }
+}
+
+QueryResult Histogram::execute(const Database& database, std::vector<OperatorResult> bitmap_filter)
+   const {
+   const storage::ColumnMetadata metadata = getNumericColumnMetadata(database, field, "Histogram");
+
+   std::vector<double> boundaries;
+   bool last_bucket_contains_upper_bound = false;
+   if (bucket_boundaries.empty()) {
+      const ValueRange range = getValueRange(database, metadata, bitmap_filter);
+      if (range.min <= range.max) {
+         boundaries = getEqualWidthBoundaries(range, metadata.type, bucket_count);
+         last_bucket_contains_upper_bound = metadata.type == ColumnType::FLOAT;
+      }
+   } else {
+      boundaries = parseBoundaries(bucket_boundaries, metadata);
+   }
+   const size_t result_bucket_count = getBucketCount(boundaries);
+
+   std::vector<std::vector<uint64_t>> counts_per_partition(database.partitions.size());
+   tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, database.partitions.size()),
+      [&](const tbb::blocked_range<size_t>& local) {
+         for (size_t partition_id = local.begin(); partition_id != local.end(); ++partition_id) {
+            const NumericColumn column(database.partitions[partition_id].columns, metadata);
+            counts_per_partition[partition_id] = countBuckets(
+               column,
+               *bitmap_filter[partition_id],
+               boundaries,
+               last_bucket_contains_upper_bound
+            );
+         }
+      }
+   );
+   std::vector<uint64_t> counts(result_bucket_count + 1);
+   for (const auto& partition_counts : counts_per_partition) {
+      for (size_t bucket = 0; bucket < partition_counts.size(); ++bucket) {
+         counts[bucket] += partition_counts[bucket];
+      }
+   }
+
+   std::vector<QueryResultEntry> result;
+   for (size_t bucket = 0; bucket < result_bucket_count; ++bucket) {
+      const std::map<std::string, common::JsonValueType> fields{
+         {LOWER_BOUND_FIELD_NAME, numericValueToJson(boundaries[bucket], metadata.type)},
+         {UPPER_BOUND_FIELD_NAME, numericValueToJson(boundaries[bucket + 1], metadata.type)},
+         {COUNT_FIELD_NAME, static_cast<int32_t>(counts[bucket])}
+      };
+      result.push_back({fields});
+   }
+   if (counts[result_bucket_count] > 0) {
+      const std::map<std::string, common::JsonValueType> fields{
+         {LOWER_BOUND_FIELD_NAME, std::nullopt},
+         {UPPER_BOUND_FIELD_NAME, std::nullopt},
+         {COUNT_FIELD_NAME, static_cast<int32_t>(counts[result_bucket_count])}
+      };
+      result.push_back({fields});
+   }
+   return {result};
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void from_json(const nlohmann::json& json, std::unique_ptr<Histogram>& action) {
+   CHECK_SILO_QUERY(
+      json.contains("field") && json["field"].is_string(),
+      "Histogram action must contain the field field of type string"
+   )
+   CHECK_SILO_QUERY(
+      !(json.contains("bucketCount") && json.contains("bucketBoundaries")),
+      "Histogram action can contain either the field bucketCount or bucketBoundaries, but not "
+      "both"
+   )
+   CHECK_SILO_QUERY(
+      !json.contains("bucketCount") ||
+         (json["bucketCount"].is_number_unsigned() && json["bucketCount"].get<uint64_t>() > 0 &&
+          json["bucketCount"].get<uint64_t>() <= Histogram::BUCKET_LIMIT),
+      fmt::format(
+         "The field bucketCount of the Histogram action must be a number in [1, {}]",
+         Histogram::BUCKET_LIMIT
+      )
+   )
+   const auto bucket_count = json.value("bucketCount", Histogram::DEFAULT_BUCKET_COUNT);
+
+   std::vector<std::variant<double, std::string>> bucket_boundaries;
+   if (json.contains("bucketBoundaries")) {
+      CHECK_SILO_QUERY(
+         json["bucketBoundaries"].is_array() && json["bucketBoundaries"].size() >= 2 &&
+            json["bucketBoundaries"].size() <= Histogram::BUCKET_LIMIT + 1,
+         fmt::format(
+            "The field bucketBoundaries of the Histogram action must be an array of 2 to {} "
+            "numbers or dates",
+            Histogram::BUCKET_LIMIT + 1
+         )
+      )
+      for (const auto& boundary : json["bucketBoundaries"]) {
+         CHECK_SILO_QUERY(
+            boundary.is_number() || boundary.is_string(),
+            "The bucket boundary " + boundary.dump() +
+               " of the Histogram action must be a number or a date"
+         )
+         if (boundary.is_number()) {
+            bucket_boundaries.emplace_back(boundary.get<double>());
+         } else {
+            bucket_boundaries.emplace_back(boundary.get<std::string>());
+         }
+      }
+   }
+
+   action = std::make_unique<Histogram>(
+      json["field"].get<std::string>(), bucket_count, std::move(bucket_boundaries)
+   );
+}
+
+}  // namespace silo::query_engine::actions
@@ -0,0 +1,74 @@
+#include "silo/query_engine/actions/indexed_column.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "silo/config/database_config.h"
+
+namespace silo::query_engine::actions {
+
+using silo::config::ColumnType;
+
+bool isIndexedColumn(const silo::storage::ColumnMetadata& metadata) {
+   return metadata.type == ColumnType::INDEXED_STRING ||
+          metadata.type == ColumnType::INDEXED_PANGOLINEAGE;
+}
+
+IndexedColumn getIndexedColumn(
+   const silo::storage::ColumnPartitionGroup& columns,
+   const silo::storage::ColumnMetadata& metadata
+) {
+   if (metadata.type == ColumnType::INDEXED_PANGOLINEAGE) {
+      const auto& column = columns.pango_lineage_columns.at(metadata.name);
+      return {column.getValues(), column.getValueBitmaps()};
+   }
+   const auto& column = columns.indexed_string_columns.at(metadata.name);
+   return {column.getValues(), column.getValueBitmaps()};
+}
+
+// Intersecting the rows with every value bitmap only pays off if there are more rows than
+// distinct values. Otherwise, the value ids of the rows are counted directly.
+void countIndexedValues(
+   const IndexedColumn& column,
+   const roaring::Roaring& rows,
+   bool rows_are_full_partition,
+   uint64_t key_prefix,
+   IndexedValueCounts& counts
+) {
+   if (rows.cardinality() < column.value_bitmaps.size()) {
+      for (const uint32_t row : rows) {
+         ++counts[key_prefix | column.value_ids[row]];
+      }
+      return;
+   }
+   if (column.value_bitmaps.size() == 1) {
+      // Every row of the partition holds the same value, e.g. for the partition_by column
+      counts[key_prefix | column.value_bitmaps.begin()->first] += rows.cardinality();
+      return;
+   }
+   for (const auto& [value_id, value_bitmap] : column.value_bitmaps) {
+      const uint64_t count = rows_are_full_partition ? value_bitmap.cardinality()
+                                                     : rows.and_cardinality(value_bitmap);
+      if (count > 0) {
+         counts[key_prefix | value_id] += count;
+      }
+   }
+}
+
+silo::common::JsonValueType lookupIndexedValue(
+   const silo::storage::ColumnPartitionGroup& columns,
+   const silo::storage::ColumnMetadata& metadata,
+   silo::Idx value_id
+) {
+   std::string value =
+      metadata.type == ColumnType::INDEXED_PANGOLINEAGE
+         ? columns.pango_lineage_columns.at(metadata.name).lookupAliasedValue(value_id).value
+         : columns.indexed_string_columns.at(metadata.name).lookupValue(value_id);
+   if (value.empty()) {
+      return std::nullopt;
+   }
+   return std::move(value);
+}
+
+}  // namespace silo::query_engine::actions
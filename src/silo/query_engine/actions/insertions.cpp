@@ -1,6 +1,7 @@
 #include "silo/query_engine/actions/insertions.h"
 
 #include <algorithm>
+#include <iterator>
 #include <map>
 #include <optional>
 #include <unordered_map>
@@ -10,6 +11,8 @@
 
 #include <fmt/format.h>
 #include <boost/container_hash/hash.hpp>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
 #include <nlohmann/json.hpp>
 
 #include "silo/common/aa_symbols.h"
@@ -113,13 +116,19 @@ template <typename SymbolType>
 void InsertionAggregation<SymbolType>::addAllColumnIndexesToPreFilteredBitmaps(
    const storage::column::InsertionColumnPartition<SymbolType>& column,
    const OperatorResult& filter,
+   bool filter_contains_all_rows,
    std::unordered_map<std::string, InsertionAggregation<SymbolType>::PrefilteredBitmaps>&
       bitmaps_to_evaluate
 ) const {
    for (const auto& [sequence_name, sequence_index] : column.getInsertionIndexes()) {
       if(sequence_names.empty() ||
           std::find(sequence_names.begin(), sequence_names.end(), sequence_name) != sequence_names.end()){
-         bitmaps_to_evaluate[sequence_name].bitmaps.emplace_back(filter, sequence_index);
+         auto& prefiltered_bitmaps = bitmaps_to_evaluate[sequence_name];
+         if (filter_contains_all_rows) {
+            prefiltered_bitmaps.full_bitmaps.emplace_back(filter, sequence_index);
+         } else {
+            prefiltered_bitmaps.bitmaps.emplace_back(filter, sequence_index);
+         }
       }
    }
 }
@@ -150,14 +159,14 @@ InsertionAggregation<SymbolType>::validateFieldsAndPreFilterBitmaps(
             }
             if (cardinality == database_partition.sequence_count) {
                addAllColumnIndexesToPreFilteredBitmaps(
-                  insertion_column, filter, pre_filtered_bitmaps
+                  insertion_column, filter, true, pre_filtered_bitmaps
                );
             } else {
                if (filter.isMutable()) {
                   filter->runOptimize();
                }
                addAllColumnIndexesToPreFilteredBitmaps(
-                  insertion_column, filter, pre_filtered_bitmaps
+                  insertion_column, filter, false, pre_filtered_bitmaps
                );
             }
          }
@@ -190,6 +199,49 @@ struct std::hash<PositionAndInsertion> {
 
 namespace silo::query_engine::actions {
 
+namespace {
+
+/// The insertion counts split by the hash of their key, so that the counts of several insertion
+/// indexes can be merged in parallel per radix partition
+constexpr size_t RADIX_PARTITION_COUNT = 64;
+
+using InsertionCounts = std::unordered_map<PositionAndInsertion, uint32_t>;
+
+template <typename SymbolType>
+std::vector<InsertionCounts> countInsertions(
+   const InsertionIndex<SymbolType>& insertion_index,
+   const OperatorResult& bitmap_filter,
+   bool filter_contains_all_rows
+) {
+   std::vector<InsertionCounts> counts_per_radix_partition(RADIX_PARTITION_COUNT);
+   const uint32_t filter_minimum = bitmap_filter->minimum();
+   const uint32_t filter_maximum = bitmap_filter->maximum();
+   for (const auto& [position, insertions_at_position] : insertion_index.getInsertionPositions()) {
+      for (const auto& insertion : insertions_at_position.insertions) {
+         uint32_t count;
+         if (filter_contains_all_rows) {
+            count = insertion.sequence_ids.cardinality();
+         } else if (insertion.sequence_ids.isEmpty() ||
+                    insertion.sequence_ids.maximum() < filter_minimum ||
+                    insertion.sequence_ids.minimum() > filter_maximum) {
+            continue;
+         } else {
+            count = insertion.sequence_ids.and_cardinality(*bitmap_filter);
+         }
+         if (count == 0) {
+            continue;
+         }
+         const PositionAndInsertion key{position, insertion.value};
+         const size_t radix_partition = std::hash<PositionAndInsertion>{}(key) %
+                                        RADIX_PARTITION_COUNT;
+         counts_per_radix_partition[radix_partition][key] += count;
+      }
+   }
+   return counts_per_radix_partition;
+}
+
+}  // namespace
+
 template <typename SymbolType>
 void InsertionAggregation<SymbolType>::addAggregatedInsertionsToInsertionCounts(
    std::vector<QueryResultEntry>& output,
@@ -197,45 +249,64 @@ void InsertionAggregation<SymbolType>::addAggregatedInsertionsToInsertionCounts(
    bool show_sequence_in_response,
    const PrefilteredBitmaps& prefiltered_bitmaps
 ) const {
-   std::unordered_map<PositionAndInsertion, uint32_t> all_insertions;
-   for (const auto& [_, insertion_index] : prefiltered_bitmaps.full_bitmaps) {
-      for (const auto& [position, insertions_at_position] :
-           insertion_index.getInsertionPositions()) {
-         for (const auto& insertion : insertions_at_position.insertions) {
-            all_insertions[PositionAndInsertion{position, insertion.value}] +=
-               insertion.sequence_ids.cardinality();
-         }
+   const size_t full_bitmap_count = prefiltered_bitmaps.full_bitmaps.size();
+   const size_t index_count = full_bitmap_count + prefiltered_bitmaps.bitmaps.size();
+
+   std::vector<std::vector<InsertionCounts>> counts_per_index(index_count);
+   tbb::parallel_for(tbb::blocked_range<size_t>(0, index_count), [&](const auto& local) {
+      for (size_t index = local.begin(); index != local.end(); ++index) {
+         const bool filter_contains_all_rows = index < full_bitmap_count;
+         const auto& [bitmap_filter, insertion_index] =
+            filter_contains_all_rows ? prefiltered_bitmaps.full_bitmaps[index]
+                                     : prefiltered_bitmaps.bitmaps[index - full_bitmap_count];
+         counts_per_index[index] =
+            countInsertions(insertion_index, bitmap_filter, filter_contains_all_rows);
       }
-   }
-   for (const auto& [bitmap_filter, insertion_index] : prefiltered_bitmaps.bitmaps) {
-      for (const auto& [position, insertions_at_position] :
-           insertion_index.getInsertionPositions()) {
-         for (const auto& insertion : insertions_at_position.insertions) {
-            const uint32_t count = insertion.sequence_ids.and_cardinality(*bitmap_filter);
-            if (count > 0) {
-               all_insertions[PositionAndInsertion{position, insertion.value}] += count;
+   });
+
+   const std::string sequence_in_response = show_sequence_in_response ? sequence_name + ":" : "";
+   std::vector<std::vector<QueryResultEntry>> entries_per_radix_partition(RADIX_PARTITION_COUNT);
+   tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, RADIX_PARTITION_COUNT),
+      [&](const auto& local) {
+         for (size_t radix_partition = local.begin(); radix_partition != local.end();
+              ++radix_partition) {
+            InsertionCounts all_insertions;
+            for (auto& counts : counts_per_index) {
+               auto& source = counts[radix_partition];
+               if (all_insertions.empty()) {
+                  all_insertions = std::move(source);
+                  continue;
+               }
+               for (const auto& [position_and_insertion, count] : source) {
+                  all_insertions[position_and_insertion] += count;
+               }
+            }
+            auto& entries = entries_per_radix_partition[radix_partition];
+            entries.reserve(all_insertions.size());
+            for (const auto& [position_and_insertion, count] : all_insertions) {
+               const std::map<std::string, common::JsonValueType> fields{
+                  {std::string(POSITION_FIELD_NAME),
+                   static_cast<int32_t>(position_and_insertion.position_idx)},
+                  {std::string(INSERTED_SYMBOLS_FIELD_NAME),
+                   std::string(position_and_insertion.insertion_value)},
+                  {std::string(SEQUENCE_FIELD_NAME), sequence_name},
+                  {std::string(INSERTION_FIELD_NAME),
+                   fmt::format(
+                      "ins_{}{}:{}",
+                      sequence_in_response,
+                      position_and_insertion.position_idx,
+                      position_and_insertion.insertion_value
+                   )},
+                  {std::string(COUNT_FIELD_NAME), static_cast<int32_t>(count)}
+               };
+               entries.push_back({fields});
             }
          }
       }
-   }
-   const std::string sequence_in_response = show_sequence_in_response ? sequence_name + ":" : "";
-   for (const auto& [position_and_insertion, count] : all_insertions) {
-      const std::map<std::string, common::JsonValueType> fields{
-         {std::string(POSITION_FIELD_NAME),
-          static_cast<int32_t>(position_and_insertion.position_idx)},
-         {std::string(INSERTED_SYMBOLS_FIELD_NAME),
-          std::string(position_and_insertion.insertion_value)},
-         {std::string(SEQUENCE_FIELD_NAME), sequence_name},
-         {std::string(INSERTION_FIELD_NAME),
-          fmt::format(
-             "ins_{}{}:{}",
-             sequence_in_response,
-             position_and_insertion.position_idx,
-             position_and_insertion.insertion_value
-          )},
-         {std::string(COUNT_FIELD_NAME), static_cast<int32_t>(count)}
-      };
-      output.push_back({fields});
+   );
+   for (auto& entries : entries_per_radix_partition) {
+      std::move(entries.begin(), entries.end(), std::back_inserter(output));
    }
 }
 
@@ -0,0 +1,262 @@
+#include "silo/query_engine/actions/mutation_cooccurrence.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <fmt/format.h>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <nlohmann/json.hpp>
+#include <roaring/roaring.hh>
+
+#include "silo/common/aa_symbols.h"
+#include "silo/common/nucleotide_symbols.h"
+#include "silo/database.h"
+#include "silo/query_engine/actions/action.h"
+#include "silo/query_engine/actions/mutations.h"
+#include "silo/query_engine/actions/parsed_mutation.h"
+#include "silo/query_engine/operator_result.h"
+#include "silo/query_engine/query_parse_exception.h"
+#include "silo/query_engine/query_result.h"
+#include "silo/storage/database_partition.h"
+#include "silo/storage/sequence_store.h"
+
+using silo::query_engine::OperatorResult;
+
+namespace silo::query_engine::actions {
+
+template <typename SymbolType>
+MutationCooccurrence<SymbolType>::MutationCooccurrence(
+   std::optional<std::string> sequence_name,
+   std::vector<std::string>&& mutations,
+   std::optional<double> min_proportion
+)
+    : sequence_name(std::move(sequence_name)),
+      mutations(std::move(mutations)),
+      min_proportion(min_proportion) {}
+
+template <typename SymbolType>
+void MutationCooccurrence<SymbolType>::validateOrderByFields(const Database& /*database*/) const {
+   const std::vector<std::string> result_field_names{
+      {MUTATION_A_FIELD_NAME, MUTATION_B_FIELD_NAME, SEQUENCE_FIELD_NAME, COUNT_FIELD_NAME}
+   };
+
+   for (const OrderByField& field : order_by_fields) {
+      CHECK_SILO_QUERY(
+         std::any_of(
+            result_field_names.begin(),
+            result_field_names.end(),
+            [&](const std::string& result_field) { return result_field == field.name; }
+         ),
+         fmt::format(
+            "OrderByField {} is not contained in the result of this operation. "
+            "Allowed values are {}.",
+            field.name,
+            fmt::join(result_field_names, ", ")
+         )
+      )
+   }
+}
+
+template <typename SymbolType>
+std::vector<std::string> MutationCooccurrence<SymbolType>::selectMutationsByProportion(
+   const Database& database,
+   const std::string& sequence_name_or_default,
+   const std::vector<OperatorResult>& bitmap_filter
+) const {
+   std::vector<OperatorResult> filter_views;
+   filter_views.reserve(bitmap_filter.size());
+   for (const auto& filter : bitmap_filter) {
+      filter_views.emplace_back(*filter);
+   }
+   const Mutations<SymbolType> mutations_action(
+      std::vector<std::string>{sequence_name_or_default}, min_proportion.value()
+   );
+   const QueryResult mutations_result =
+      mutations_action.executeAndOrder(database, std::move(filter_views));
+
+   std::vector<std::string> selected_mutations;
+   for (const auto& entry : mutations_result.query_result) {
+      const auto& mutation = entry.fields.at("mutation");
+      if (mutation.has_value() && std::holds_alternative<std::string>(mutation.value())) {
+         selected_mutations.emplace_back(std::get<std::string>(mutation.value()));
+      }
+   }
+   return selected_mutations;
+}
+
+template <typename SymbolType>
+QueryResult MutationCooccurrence<SymbolType>::execute(
+   const Database& database,
+   std::vector<OperatorResult> bitmap_filter
+) const {
+   CHECK_SILO_QUERY(
+      sequence_name.has_value() || database.getDefaultSequenceName<SymbolType>().has_value(),
+      fmt::format(
+         "Database does not have a default sequence name for {} Sequences", SymbolType::SYMBOL_NAME
+      )
+   )
+   const std::string sequence_name_or_default =
+      sequence_name.value_or(database.getDefaultSequenceName<SymbolType>().value_or(""));
+   CHECK_SILO_QUERY(
+      database.getSequenceStores<SymbolType>().contains(sequence_name_or_default),
+      "Database does not contain the " + std::string(SymbolType::SYMBOL_NAME_LOWER_CASE) +
+         " sequence with name: '" + sequence_name_or_default + "'"
+   )
+   const auto& reference_sequence =
+      database.getSequenceStores<SymbolType>().at(sequence_name_or_default).reference_sequence;
+
+   const std::vector<std::string> mutation_names =
+      min_proportion.has_value()
+         ? selectMutationsByProportion(database, sequence_name_or_default, bitmap_filter)
+         : mutations;
+   CHECK_SILO_QUERY(
+      mutation_names.size() <= MUTATION_LIMIT,
+      fmt::format(
+         "MutationCooccurrence action is limited to {} mutations, but {} were selected",
+         MUTATION_LIMIT,
+         mutation_names.size()
+      )
+   )
+   std::vector<ParsedMutation<SymbolType>> parsed_mutations;
+   parsed_mutations.reserve(mutation_names.size());
+   for (const auto& mutation_name : mutation_names) {
+      parsed_mutations.emplace_back(
+         ParsedMutation<SymbolType>::parse(mutation_name, reference_sequence)
+      );
+   }
+
+   // The rows of every partition that match the filter and have the mutation
+   std::vector<std::vector<roaring::Roaring>> mutation_rows_per_partition(
+      database.partitions.size(), std::vector<roaring::Roaring>(parsed_mutations.size())
+   );
+   tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, database.partitions.size()),
+      [&](const auto& local) {
+         for (size_t partition_index = local.begin(); partition_index != local.end();
+              ++partition_index) {
+            const auto& filter = bitmap_filter[partition_index];
+            if (filter->isEmpty()) {
+               continue;
+            }
+            const DatabasePartition& database_partition = database.partitions[partition_index];
+            for (size_t mutation_index = 0; mutation_index < parsed_mutations.size();
+                 ++mutation_index) {
+               mutation_rows_per_partition[partition_index][mutation_index] =
+                  parsed_mutations[mutation_index].getRowsWithMutation(
+                     database, database_partition, sequence_name_or_default, *filter
+                  );
+            }
+         }
+      }
+   );
+
+   std::vector<std::pair<size_t, size_t>> mutation_pairs;
+   for (size_t first = 0; first < parsed_mutations.size(); ++first) {
+      for (size_t second = first; second < parsed_mutations.size(); ++second) {
+         mutation_pairs.emplace_back(first, second);
+      }
+   }
+   std::vector<uint64_t> count_per_pair(mutation_pairs.size());
+   tbb::parallel_for(tbb::blocked_range<size_t>(0, mutation_pairs.size()), [&](const auto& local) {
+      for (size_t pair_index = local.begin(); pair_index != local.end(); ++pair_index) {
+         const auto [first, second] = mutation_pairs[pair_index];
+         uint64_t count = 0;
+         for (const auto& mutation_rows : mutation_rows_per_partition) {
+            count += first == second
+                        ? mutation_rows[first].cardinality()
+                        : mutation_rows[first].and_cardinality(mutation_rows[second]);
+         }
+         count_per_pair[pair_index] = count;
+      }
+   });
+
+   std::vector<QueryResultEntry> cooccurrence_counts;
+   cooccurrence_counts.reserve(mutation_pairs.size());
+   for (size_t pair_index = 0; pair_index < mutation_pairs.size(); ++pair_index) {
+      const auto [first, second] = mutation_pairs[pair_index];
+      const std::map<std::string, common::JsonValueType> fields{
+         {MUTATION_A_FIELD_NAME, parsed_mutations[first].name},
+         {MUTATION_B_FIELD_NAME, parsed_mutations[second].name},
+         {SEQUENCE_FIELD_NAME, sequence_name_or_default},
+         {COUNT_FIELD_NAME, static_cast<int32_t>(count_per_pair[pair_index])}
+      };
+      cooccurrence_counts.push_back({fields});
+   }
+   return {cooccurrence_counts};
+}
+
+template <typename SymbolType>
+// NOLINTNEXTLINE(readability-identifier-naming)
+void from_json(
+   const nlohmann::json& json,
+   std::unique_ptr<MutationCooccurrence<SymbolType>>& action
+) {
+   CHECK_SILO_QUERY(
+      !json.contains("sequenceName") || json["sequenceName"].is_string(),
+      "MutationCooccurrence action can have the field sequenceName of type string, but no other "
+      "type"
+   )
+   std::optional<std::string> sequence_name;
+   if (json.contains("sequenceName")) {
+      sequence_name = json["sequenceName"].get<std::string>();
+   }
+
+   CHECK_SILO_QUERY(
+      json.contains("mutations") != json.contains("minProportion"),
+      "MutationCooccurrence action must contain either the field mutations or the field "
+      "minProportion"
+   )
+   std::vector<std::string> mutations;
+   if (json.contains("mutations")) {
+      CHECK_SILO_QUERY(
+         json["mutations"].is_array(),
+         "The field mutations of the MutationCooccurrence action must be an array of strings"
+      )
+      for (const auto& child : json["mutations"]) {
+         CHECK_SILO_QUERY(
+            child.is_string(),
+            "The field mutations of the MutationCooccurrence action must be an array of "
+            "strings. Found:" +
+               child.dump()
+         )
+         mutations.emplace_back(child.get<std::string>());
+      }
+   }
+
+   std::optional<double> min_proportion;
+   if (json.contains("minProportion")) {
+      CHECK_SILO_QUERY(
+         json["minProportion"].is_number(),
+         "The field minProportion of the MutationCooccurrence action must be a number with "
+         "limits [0.0, 1.0]"
+      )
+      min_proportion = json["minProportion"].get<double>();
+      if (*min_proportion < 0 || *min_proportion > 1) {
+         throw QueryParseException("Invalid proportion: minProportion must be in interval [0.0, 1.0]"
+         );
+      }
+   }
+
+   action = std::make_unique<MutationCooccurrence<SymbolType>>(
+      std::move(sequence_name), std::move(mutations), min_proportion
+   );
+}
+
+template class MutationCooccurrence<AminoAcid>;
+template class MutationCooccurrence<Nucleotide>;
+// NOLINTNEXTLINE(readability-identifier-naming)
+template void from_json<AminoAcid>(
+   const nlohmann::json& json,
+   std::unique_ptr<MutationCooccurrence<AminoAcid>>& action
+);
+// NOLINTNEXTLINE(readability-identifier-naming)
+template void from_json<Nucleotide>(
+   const nlohmann::json& json,
+   std::unique_ptr<MutationCooccurrence<Nucleotide>>& action
+);
+
+}  // namespace silo::query_engine::actions
@@ -9,8 +9,6 @@
 #include <vector>
 
 #include <fmt/format.h>
-#include <oneapi/tbb/blocked_range.h>
-#include <oneapi/tbb/parallel_for.h>
 #include <nlohmann/json.hpp>
 
 #include "silo/common/aa_symbols.h"
@@ -18,6 +16,8 @@
 #include "silo/common/symbol_map.h"
 #include "silo/database.h"
 #include "silo/query_engine/actions/action.h"
+#include "silo/query_engine/actions/approximation.h"
+#include "silo/query_engine/actions/symbol_counts.h"
 #include "silo/query_engine/operator_result.h"
 #include "silo/query_engine/query_parse_exception.h"
 #include "silo/query_engine/query_result.h"
@@ -29,144 +29,18 @@ using silo::query_engine::OperatorResult;
 namespace silo::query_engine::actions {
 
 template <typename SymbolType>
-Mutations<SymbolType>::Mutations(std::vector<std::string>&& sequence_names, double min_proportion)
+Mutations<SymbolType>::Mutations(
+   std::vector<std::string>&& sequence_names,
+   double min_proportion,
+   std::optional<Approximation> approximation
+)
     : sequence_names(std::move(sequence_names)),
-      min_proportion(min_proportion) {}
-
-template <typename SymbolType>
-std::unordered_map<std::string, typename Mutations<SymbolType>::PrefilteredBitmaps> Mutations<
-   SymbolType>::
-   preFilterBitmaps(const silo::Database& database, std::vector<OperatorResult>& bitmap_filter) {
-   std::unordered_map<std::string, PrefilteredBitmaps> bitmaps_to_evaluate;
-   for (size_t i = 0; i < database.partitions.size(); ++i) {
-      const DatabasePartition& database_partition = database.partitions.at(i);
-      OperatorResult& filter = bitmap_filter[i];
-      const size_t cardinality = filter->cardinality();
-      if (cardinality == 0) {
-         continue;
-      }
-      if (cardinality == database_partition.sequence_count) {
-         for (const auto& [sequence_name, sequence_store] :
-              database_partition.getSequenceStores<SymbolType>()) {
-            bitmaps_to_evaluate[sequence_name].full_bitmaps.emplace_back(filter, sequence_store);
-         }
-      } else {
-         if (filter.isMutable()) {
-            filter->runOptimize();
-         }
-         for (const auto& [sequence_name, sequence_store] :
-              database_partition.getSequenceStores<SymbolType>()) {
-            bitmaps_to_evaluate[sequence_name].bitmaps.emplace_back(filter, sequence_store);
-         }
-      }
-   }
-   return bitmaps_to_evaluate;
-}
-
-template <typename SymbolType>
-void Mutations<SymbolType>::addPositionToMutationCountsForMixedBitmaps(
-   uint32_t position_idx,
-   const PrefilteredBitmaps& bitmaps_to_evaluate,
-   SymbolMap<SymbolType, std::vector<uint32_t>>& count_of_mutations_per_position
-) {
-   for (const auto& [filter, sequence_store_partition] : bitmaps_to_evaluate.bitmaps) {
-      for (const auto symbol : SymbolType::SYMBOLS) {
-         const auto& current_position = sequence_store_partition.positions[position_idx];
-         if (current_position.isSymbolDeleted(symbol)) {
-            count_of_mutations_per_position[symbol][position_idx] += filter->cardinality();
-            for (const uint32_t idx : *filter) {
-               const roaring::Roaring& n_bitmap =
-                  sequence_store_partition.missing_symbol_bitmaps[idx];
-               if (n_bitmap.contains(position_idx)) {
-                  count_of_mutations_per_position[symbol][position_idx] -= 1;
-               }
-            }
-            continue;
-         }
-         const uint32_t symbol_count =
-            current_position.isSymbolFlipped(symbol)
-               ? filter->andnot_cardinality(*current_position.getBitmap(symbol))
-               : filter->and_cardinality(*current_position.getBitmap(symbol));
-
-         count_of_mutations_per_position[symbol][position_idx] += symbol_count;
-
-         const auto deleted_symbol = current_position.getDeletedSymbol();
-         if (deleted_symbol.has_value() && symbol != *deleted_symbol) {
-            count_of_mutations_per_position[*deleted_symbol][position_idx] -= symbol_count;
-         }
-      }
-   }
-}
-
-template <typename SymbolType>
-void Mutations<SymbolType>::addPositionToMutationCountsForFullBitmaps(
-   uint32_t position_idx,
-   const PrefilteredBitmaps& bitmaps_to_evaluate,
-   SymbolMap<SymbolType, std::vector<uint32_t>>& count_of_mutations_per_position
-) {
-   // For these partitions, we have full bitmaps. Do not need to bother with AND
-   // cardinality
-   for (const auto& [filter, sequence_store_partition] : bitmaps_to_evaluate.full_bitmaps) {
-      for (const auto symbol : SymbolType::SYMBOLS) {
-         const auto& current_position = sequence_store_partition.positions[position_idx];
-         if (current_position.isSymbolDeleted(symbol)) {
-            count_of_mutations_per_position[symbol][position_idx] +=
-               sequence_store_partition.sequence_count;
-            for (const roaring::Roaring& n_bitmap :
-                 sequence_store_partition.missing_symbol_bitmaps) {
-               if (n_bitmap.contains(position_idx)) {
-                  count_of_mutations_per_position[symbol][position_idx] -= 1;
-               }
-            }
-            continue;
-         }
-         const uint32_t symbol_count = current_position.isSymbolFlipped(symbol)
-                                          ? sequence_store_partition.sequence_count -
-                                               current_position.getBitmap(symbol)->cardinality()
-                                          : current_position.getBitmap(symbol)->cardinality();
-
-         count_of_mutations_per_position[symbol][position_idx] += symbol_count;
-
-         const auto deleted_symbol = current_position.getDeletedSymbol();
-         if (deleted_symbol.has_value() && symbol != *deleted_symbol) {
-            count_of_mutations_per_position[*deleted_symbol][position_idx] -=
-               sequence_store_partition.positions[position_idx].getBitmap(symbol)->cardinality();
-         }
-      }
-   }
-}
-
-template <typename SymbolType>
-SymbolMap<SymbolType, std::vector<uint32_t>> Mutations<SymbolType>::calculateMutationsPerPosition(
-   const SequenceStore<SymbolType>& sequence_store,
-   const PrefilteredBitmaps& bitmap_filter
-) {
-   const size_t sequence_length = sequence_store.reference_sequence.size();
-
-   SymbolMap<SymbolType, std::vector<uint32_t>> mutation_counts_per_position;
-   for (const auto symbol : SymbolType::SYMBOLS) {
-      mutation_counts_per_position[symbol].resize(sequence_length);
-   }
-   static constexpr int POSITIONS_PER_PROCESS = 300;
-   tbb::parallel_for(
-      tbb::blocked_range<uint32_t>(0, sequence_length, /*grain_size=*/POSITIONS_PER_PROCESS),
-      [&](const auto& local) {
-         for (uint32_t pos = local.begin(); pos != local.end(); ++pos) {
-            addPositionToMutationCountsForMixedBitmaps(
-               pos, bitmap_filter, mutation_counts_per_position
-            );
-            addPositionToMutationCountsForFullBitmaps(
-               pos, bitmap_filter, mutation_counts_per_position
-            );
-         }
-      }
-   );
-   return mutation_counts_per_position;
-}
+      min_proportion(min_proportion),
+      approximation(approximation) {}
 
 template <typename SymbolType>
 void Mutations<SymbolType>::validateOrderByFields(const Database& /*database*/) const {
-   const std::vector<std::string> result_field_names{
+   std::vector<std::string> result_field_names{
       {MUTATION_FIELD_NAME,
        MUTATION_FROM_FIELD_NAME,
        MUTATION_TO_FIELD_NAME,
@@ -175,6 +49,15 @@ void Mutations<SymbolType>::validateOrderByFields(const Database& /*database*/)
        SEQUENCE_FIELD_NAME,
        COUNT_FIELD_NAME}
    };
+   if (approximation.has_value()) {
+      result_field_names.insert(
+         result_field_names.end(),
+         {COUNT_LOWER_FIELD_NAME,
+          COUNT_UPPER_FIELD_NAME,
+          PROPORTION_LOWER_FIELD_NAME,
+          PROPORTION_UPPER_FIELD_NAME}
+      );
+   }
 
    for (const OrderByField& field : order_by_fields) {
       CHECK_SILO_QUERY(
@@ -197,7 +80,8 @@ template <typename SymbolType>
 void Mutations<SymbolType>::addMutationsToOutput(
    const std::string& sequence_name,
    const SequenceStore<SymbolType>& sequence_store,
-   const PrefilteredBitmaps& bitmap_filter,
+   const PrefilteredBitmaps<SymbolType>& bitmap_filter,
+   const std::optional<FilterSample>& filter_sample,
    std::vector<QueryResultEntry>& output
 ) const {
    const size_t sequence_length = sequence_store.reference_sequence.size();
@@ -226,7 +110,7 @@ void Mutations<SymbolType>::addMutationsToOutput(
             const uint32_t count = count_of_mutations_per_position.at(symbol)[pos];
             if (count > threshold_count) {
                const double proportion = static_cast<double>(count) / static_cast<double>(total);
-               const std::map<std::string, common::JsonValueType> fields{
+               std::map<std::string, common::JsonValueType> fields{
                   {
                      MUTATION_FIELD_NAME,
                      fmt::format(
@@ -246,6 +130,16 @@ void Mutations<SymbolType>::addMutationsToOutput(
                   {PROPORTION_FIELD_NAME, proportion},
                   {COUNT_FIELD_NAME, static_cast<int32_t>(count)}
                };
+               if (filter_sample.has_value()) {
+                  const CountEstimate count_estimate = filter_sample->estimateCount(count);
+                  const ProportionEstimate proportion_estimate =
+                     filter_sample->estimateProportion(count, total);
+                  fields[COUNT_FIELD_NAME] = static_cast<int32_t>(count_estimate.count);
+                  fields[COUNT_LOWER_FIELD_NAME] = static_cast<int32_t>(count_estimate.lower);
+                  fields[COUNT_UPPER_FIELD_NAME] = static_cast<int32_t>(count_estimate.upper);
+                  fields[PROPORTION_LOWER_FIELD_NAME] = proportion_estimate.lower;
+                  fields[PROPORTION_UPPER_FIELD_NAME] = proportion_estimate.upper;
+               }
                output.push_back({fields});
             }
          }
@@ -273,8 +167,13 @@ QueryResult Mutations<SymbolType>::execute(
       }
    }
 
-   std::unordered_map<std::string, Mutations<SymbolType>::PrefilteredBitmaps> bitmaps_to_evaluate =
-      preFilterBitmaps(database, bitmap_filter);
+   std::optional<FilterSample> filter_sample;
+   if (approximation.has_value()) {
+      filter_sample = sampleFilter(database, bitmap_filter, *approximation);
+   }
+
+   std::unordered_map<std::string, PrefilteredBitmaps<SymbolType>> bitmaps_to_evaluate =
+      preFilterBitmaps<SymbolType>(database, bitmap_filter);
 
    std::vector<QueryResultEntry> mutation_proportions;
    for (const auto& sequence_name : sequence_names_to_evaluate) {
@@ -286,6 +185,7 @@ QueryResult Mutations<SymbolType>::execute(
             sequence_name,
             sequence_store,
             bitmaps_to_evaluate.at(sequence_name),
+            filter_sample,
             mutation_proportions
          );
       }
@@ -329,7 +229,9 @@ void from_json(const nlohmann::json& json, std::unique_ptr<Mutations<SymbolType>
       throw QueryParseException("Invalid proportion: minProportion must be in interval [0.0, 1.0]");
    }
 
-   action = std::make_unique<Mutations<SymbolType>>(std::move(sequence_names), min_proportion);
+   action = std::make_unique<Mutations<SymbolType>>(
+      std::move(sequence_names), min_proportion, parseApproximation(json, "Mutations")
+   );
 }
 
 template class Mutations<AminoAcid>;
@@ -0,0 +1,330 @@
+#include "silo/query_engine/actions/mutations_over_time.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <nlohmann/json.hpp>
+#include <roaring/roaring.hh>
+
+#include "silo/common/aa_symbols.h"
+#include "silo/common/nucleotide_symbols.h"
+#include "silo/config/database_config.h"
+#include "silo/database.h"
+#include "silo/query_engine/actions/action.h"
+#include "silo/query_engine/actions/date_runs.h"
+#include "silo/query_engine/actions/parsed_mutation.h"
+#include "silo/query_engine/filter_expressions/expression.h"
+#include "silo/query_engine/filter_expressions/symbol_equals.h"
+#include "silo/query_engine/operator_result.h"
+#include "silo/query_engine/query_parse_exception.h"
+#include "silo/query_engine/query_result.h"
+#include "silo/storage/column/date_column.h"
+#include "silo/storage/database_partition.h"
+#include "silo/storage/sequence_store.h"
+
+using silo::query_engine::OperatorResult;
+using silo::query_engine::filter_expressions::Expression;
+using silo::query_engine::filter_expressions::SymbolEquals;
+
+namespace silo::query_engine::actions {
+
+namespace {
+
+/// The number of sequences with and the coverage of every mutation for one truncated date
+struct DateCounts {
+   std::vector<uint64_t> counts;
+   std::vector<uint64_t> coverages;
+
+   explicit DateCounts(size_t mutation_count)
+       : counts(mutation_count),
+         coverages(mutation_count) {}
+};
+
+/// The rows of the filter with an invalid mutation symbol other than the missing symbol at the
+/// position. The rows with the missing symbol are taken from the missing symbol bitmaps instead.
+template <typename SymbolType>
+roaring::Roaring getRowsWithAmbiguousSymbol(
+   const Database& database,
+   const DatabasePartition& database_partition,
+   const std::string& sequence_name,
+   uint32_t position_idx,
+   const roaring::Roaring& filter
+) {
+   roaring::Roaring rows;
+   for (const auto symbol : SymbolType::INVALID_MUTATION_SYMBOLS) {
+      if (symbol == SymbolType::SYMBOL_MISSING) {
+         continue;
+      }
+      const SymbolEquals<SymbolType> symbol_equals(sequence_name, position_idx, symbol);
+      rows |= *symbol_equals.compile(database, database_partition, Expression::NONE)->evaluate();
+   }
+   return rows & filter;
+}
+
+}  // namespace
+
+template <typename SymbolType>
+MutationsOverTime<SymbolType>::MutationsOverTime(
+   std::optional<std::string> sequence_name,
+   std::vector<std::string>&& mutations,
+   std::string date_field,
+   common::DateTruncation truncation
+)
+    : sequence_name(std::move(sequence_name)),
+      mutations(std::move(mutations)),
+      date_field(std::move(date_field)),
+      truncation(truncation) {}
+
+template <typename SymbolType>
+void MutationsOverTime<SymbolType>::validateOrderByFields(const Database& /*database*/) const {
+   const std::vector<std::string> result_field_names{
+      {date_field, MUTATION_FIELD_NAME, SEQUENCE_FIELD_NAME, COUNT_FIELD_NAME, COVERAGE_FIELD_NAME}
+   };
+
+   for (const OrderByField& field : order_by_fields) {
+      CHECK_SILO_QUERY(
+         std::any_of(
+            result_field_names.begin(),
+            result_field_names.end(),
+            [&](const std::string& result_field) { return result_field == field.name; }
+         ),
+         fmt::format(
+            "OrderByField {} is not contained in the result of this operation. "
+            "Allowed values are {}.",
+            field.name,
+            fmt::join(result_field_names, ", ")
+         )
+      )
+   }
+}
+
+template <typename SymbolType>
+QueryResult MutationsOverTime<SymbolType>::execute(
+   const Database& database,
+   std::vector<OperatorResult> bitmap_filter
+) const {
+   CHECK_SILO_QUERY(
+      sequence_name.has_value() || database.getDefaultSequenceName<SymbolType>().has_value(),
+      fmt::format(
+         "Database does not have a default sequence name for {} Sequences", SymbolType::SYMBOL_NAME
+      )
+   )
+   const std::string sequence_name_or_default =
+      sequence_name.value_or(database.getDefaultSequenceName<SymbolType>().value_or(""));
+   CHECK_SILO_QUERY(
+      database.getSequenceStores<SymbolType>().contains(sequence_name_or_default),
+      "Database does not contain the " + std::string(SymbolType::SYMBOL_NAME_LOWER_CASE) +
+         " sequence with name: '" + sequence_name_or_default + "'"
+   )
+   const auto& metadata = database.database_config.getMetadata(date_field);
+   CHECK_SILO_QUERY(
+      metadata.has_value() && metadata->getColumnType() == config::ColumnType::DATE,
+      "The dateField '" + date_field + "' of the MutationsOverTime action must be a date field"
+   )
+   CHECK_SILO_QUERY(
+      mutations.size() <= MUTATION_LIMIT,
+      fmt::format("MutationsOverTime action is limited to {} mutations", MUTATION_LIMIT)
+   )
+   const auto& reference_sequence =
+      database.getSequenceStores<SymbolType>().at(sequence_name_or_default).reference_sequence;
+   std::vector<ParsedMutation<SymbolType>> parsed_mutations;
+   parsed_mutations.reserve(mutations.size());
+   for (const auto& mutation : mutations) {
+      parsed_mutations.emplace_back(ParsedMutation<SymbolType>::parse(mutation, reference_sequence)
+      );
+   }
+
+   std::vector<std::map<common::Date, DateCounts>> counts_per_partition(
+      database.partitions.size()
+   );
+   tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, database.partitions.size()),
+      [&](const auto& local) {
+         for (size_t partition_index = local.begin(); partition_index != local.end();
+              ++partition_index) {
+            const roaring::Roaring& filter = *bitmap_filter[partition_index];
+            if (filter.isEmpty()) {
+               continue;
+            }
+            const DatabasePartition& database_partition = database.partitions[partition_index];
+            const auto& sequence_store =
+               database_partition.getSequenceStores<SymbolType>().at(sequence_name_or_default);
+
+            // The filtered rows with the mutation and with an invalid symbol at its position
+            std::vector<roaring::Roaring> mutation_rows;
+            std::map<uint32_t, roaring::Roaring> invalid_rows_per_position;
+            roaring::Roaring query_positions;
+            for (const auto& mutation : parsed_mutations) {
+               mutation_rows.emplace_back(mutation.getRowsWithMutation(
+                  database, database_partition, sequence_name_or_default, filter
+               ));
+               if (!invalid_rows_per_position.contains(mutation.position_idx)) {
+                  invalid_rows_per_position.emplace(
+                     mutation.position_idx,
+                     getRowsWithAmbiguousSymbol<SymbolType>(
+                        database,
+                        database_partition,
+                        sequence_name_or_default,
+                        mutation.position_idx,
+                        filter
+                     )
+                  );
+               }
+               query_positions.add(mutation.position_idx);
+            }
+            // Only the requested positions that are missing in a row are visited
+            for (const uint32_t row : filter) {
+               const roaring::Roaring& missing_positions =
+                  sequence_store.missing_symbol_bitmaps.at(row);
+               if (!missing_positions.intersect(query_positions)) {
+                  continue;
+               }
+               for (const uint32_t position_idx : missing_positions & query_positions) {
+                  invalid_rows_per_position.at(position_idx).add(row);
+               }
+            }
+
+            auto& counts = counts_per_partition[partition_index];
+            const auto& date_column = database_partition.columns.date_columns.at(date_field);
+            if (date_column.isSorted()) {
+               // The dates are sorted within chunks, so every truncated date is a range of rows
+               for (const auto& run : getTruncatedDateRuns(
+                       date_column.getValues(), database_partition.getChunks(), truncation
+                    )) {
+                  const uint64_t filtered_count = countRowsInRange(filter, run.begin, run.end);
+                  if (filtered_count == 0) {
+                     continue;
+                  }
+                  auto& date_counts =
+                     counts.try_emplace(run.date, parsed_mutations.size()).first->second;
+                  for (size_t index = 0; index < parsed_mutations.size(); ++index) {
+                     const auto& invalid_rows =
+                        invalid_rows_per_position.at(parsed_mutations[index].position_idx);
+                     date_counts.counts[index] +=
+                        countRowsInRange(mutation_rows[index], run.begin, run.end);
+                     date_counts.coverages[index] +=
+                        filtered_count - countRowsInRange(invalid_rows, run.begin, run.end);
+                  }
+               }
+               continue;
+            }
+            std::map<common::Date, roaring::Roaring> rows_per_date;
+            for (const uint32_t row : filter) {
+               rows_per_date[common::truncateDate(date_column.getValues()[row], truncation)].add(
+                  row
+               );
+            }
+            for (const auto& [date, rows] : rows_per_date) {
+               const uint64_t filtered_count = rows.cardinality();
+               auto& date_counts = counts.try_emplace(date, parsed_mutations.size()).first->second;
+               for (size_t index = 0; index < parsed_mutations.size(); ++index) {
+                  const auto& invalid_rows =
+                     invalid_rows_per_position.at(parsed_mutations[index].position_idx);
+                  date_counts.counts[index] += mutation_rows[index].and_cardinality(rows);
+                  date_counts.coverages[index] +=
+                     filtered_count - invalid_rows.and_cardinality(rows);
+               }
+            }
+         }
+      }
+   );
+
+   std::map<common::Date, DateCounts> final_counts;
+   for (const auto& counts : counts_per_partition) {
+      for (const auto& [date, date_counts] : counts) {
+         auto& final_date_counts =
+            final_counts.try_emplace(date, parsed_mutations.size()).first->second;
+         for (size_t index = 0; index < parsed_mutations.size(); ++index) {
+            final_date_counts.counts[index] += date_counts.counts[index];
+            final_date_counts.coverages[index] += date_counts.coverages[index];
+         }
+      }
+   }
+
+   std::vector<QueryResultEntry> result;
+   for (const auto& [date, date_counts] : final_counts) {
+      const common::JsonValueType date_value = common::dateToString(date);
+      for (size_t index = 0; index < parsed_mutations.size(); ++index) {
+         const std::map<std::string, common::JsonValueType> fields{
+            {date_field, date_value},
+            {MUTATION_FIELD_NAME, parsed_mutations[index].name},
+            {SEQUENCE_FIELD_NAME, sequence_name_or_default},
+            {COUNT_FIELD_NAME, static_cast<int32_t>(date_counts.counts[index])},
+            {COVERAGE_FIELD_NAME, static_cast<int32_t>(date_counts.coverages[index])}
+         };
+         result.push_back({fields});
+      }
+   }
+   return {result};
+}
+
+template <typename SymbolType>
+// NOLINTNEXTLINE(readability-identifier-naming)
+void from_json(const nlohmann::json& json, std::unique_ptr<MutationsOverTime<SymbolType>>& action) {
+   CHECK_SILO_QUERY(
+      !json.contains("sequenceName") || json["sequenceName"].is_string(),
+      "MutationsOverTime action can have the field sequenceName of type string, but no other type"
+   )
+   std::optional<std::string> sequence_name;
+   if (json.contains("sequenceName")) {
+      sequence_name = json["sequenceName"].get<std::string>();
+   }
+
+   CHECK_SILO_QUERY(
+      json.contains("mutations") && json["mutations"].is_array(),
+      "MutationsOverTime action must contain the field mutations of type array of strings"
+   )
+   std::vector<std::string> mutations;
+   for (const auto& child : json["mutations"]) {
+      CHECK_SILO_QUERY(
+         child.is_string(),
+         "The field mutations of the MutationsOverTime action must be an array of strings. "
+         "Found:" +
+            child.dump()
+      )
+      mutations.emplace_back(child.get<std::string>());
+   }
+
+   CHECK_SILO_QUERY(
+      json.contains("dateField") && json["dateField"].is_string(),
+      "MutationsOverTime action must contain the field dateField of type string"
+   )
+   CHECK_SILO_QUERY(
+      !json.contains("truncateTo") ||
+         (json["truncateTo"].is_string() &&
+          DATE_TRUNCATION_NAMES.contains(json["truncateTo"].get<std::string>())),
+      "The field truncateTo of the MutationsOverTime action must be 'day', 'week', 'month', "
+      "'quarter' or 'year'"
+   )
+   const common::DateTruncation truncation =
+      DATE_TRUNCATION_NAMES.at(json.value("truncateTo", std::string{"day"}));
+
+   action = std::make_unique<MutationsOverTime<SymbolType>>(
+      std::move(sequence_name),
+      std::move(mutations),
+      json["dateField"].get<std::string>(),
+      truncation
+   );
+}
+
+template class MutationsOverTime<AminoAcid>;
+template class MutationsOverTime<Nucleotide>;
+// NOLINTNEXTLINE(readability-identifier-naming)
+template void from_json<AminoAcid>(
+   const nlohmann::json& json,
+   std::unique_ptr<MutationsOverTime<AminoAcid>>& action
+);
+// NOLINTNEXTLINE(readability-identifier-naming)
+template void from_json<Nucleotide>(
+   const nlohmann::json& json,
+   std::unique_ptr<MutationsOverTime<Nucleotide>>& action
+);
+
+}  // namespace silo::query_engine::actions
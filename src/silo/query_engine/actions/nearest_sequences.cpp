@@ -0,0 +1,376 @@
+#include "silo/query_engine/actions/nearest_sequences.h"
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <fmt/format.h>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <nlohmann/json.hpp>
+#include <roaring/roaring.hh>
+
+#include "silo/common/aa_symbols.h"
+#include "silo/common/nucleotide_symbols.h"
+#include "silo/database.h"
+#include "silo/query_engine/actions/action.h"
+#include "silo/query_engine/actions/parsed_mutation.h"
+#include "silo/query_engine/operator_result.h"
+#include "silo/query_engine/query_parse_exception.h"
+#include "silo/query_engine/query_result.h"
+#include "silo/storage/database_partition.h"
+#include "silo/storage/sequence_store.h"
+
+using silo::query_engine::OperatorResult;
+
+namespace silo::query_engine::actions {
+
+namespace {
+
+struct Neighbor {
+   int32_t distance;
+   int32_t compared_positions;
+   size_t partition_id;
+   uint32_t row;
+
+   /// Smaller distances first, and among equal distances the better covered sequences
+   bool operator<(const Neighbor& other) const {
+      return std::tie(distance, other.compared_positions, partition_id, row) <
+             std::tie(other.distance, compared_positions, other.partition_id, other.row);
+   }
+};
+
+template <typename Function>
+void forEachFilteredRow(
+   const roaring::Roaring& bitmap,
+   const roaring::Roaring& filter,
+   bool filter_is_full,
+   Function function
+) {
+   if (filter_is_full) {
+      for (const uint32_t row : bitmap) {
+         function(row);
+      }
+      return;
+   }
+   for (const uint32_t row : bitmap & filter) {
+      function(row);
+   }
+}
+
+/// The distances of all filtered rows of one partition are
+///    |positions where the query symbol has a regular bitmap|
+///    - |those of them where the row has the query symbol|
+///    + |positions where the query symbol's bitmap is flipped and the row is in that bitmap|
+///    + |positions where the query symbol's bitmap is deleted and the row has another symbol|
+///    - |positions of the first two kinds where the row is missing|
+/// The per-row terms are accumulated in one counter per row.
+template <typename SymbolType>
+std::vector<Neighbor> findNearestInPartition(
+   const SequenceStorePartition<SymbolType>& sequence_store,
+   const std::vector<std::optional<typename SymbolType::Symbol>>& query_symbols,
+   const roaring::Roaring& filter,
+   size_t partition_id,
+   uint32_t k
+) {
+   const bool filter_is_full = filter.cardinality() == sequence_store.sequence_count;
+   std::vector<int32_t> counters(sequence_store.sequence_count);
+   int32_t regular_position_count = 0;
+   roaring::Roaring compared_positions;
+   roaring::Roaring positions_counting_missing_rows;
+
+   for (uint32_t position_idx = 0; position_idx < query_symbols.size(); ++position_idx) {
+      const auto& query_symbol = query_symbols[position_idx];
+      if (!query_symbol.has_value()) {
+         continue;
+      }
+      compared_positions.add(position_idx);
+      const auto& position = sequence_store.positions[position_idx];
+      if (position.isSymbolDeleted(*query_symbol)) {
+         roaring::Roaring rows_with_other_symbol;
+         for (const auto symbol : SymbolType::SYMBOLS) {
+            if (symbol == *query_symbol || symbol == SymbolType::SYMBOL_MISSING) {
+               continue;
+            }
+            // Flipped bitmaps contain the missing rows, so their complement does not
+            rows_with_other_symbol |= position.isSymbolFlipped(symbol)
+                                         ? filter - *position.getBitmap(symbol)
+                                         : filter & *position.getBitmap(symbol);
+         }
+         for (const uint32_t row : rows_with_other_symbol) {
+            ++counters[row];
+         }
+         continue;
+      }
+      positions_counting_missing_rows.add(position_idx);
+      const roaring::Roaring& query_symbol_bitmap = *position.getBitmap(*query_symbol);
+      if (position.isSymbolFlipped(*query_symbol)) {
+         forEachFilteredRow(query_symbol_bitmap, filter, filter_is_full, [&](uint32_t row) {
+            ++counters[row];
+         });
+      } else {
+         ++regular_position_count;
+         forEachFilteredRow(query_symbol_bitmap, filter, filter_is_full, [&](uint32_t row) {
+            --counters[row];
+         });
+      }
+   }
+   compared_positions.runOptimize();
+   positions_counting_missing_rows.runOptimize();
+   const auto compared_position_count = static_cast<int32_t>(compared_positions.cardinality());
+
+   std::vector<Neighbor> neighbors;
+   neighbors.reserve(filter.cardinality());
+   for (const uint32_t row : filter) {
+      const roaring::Roaring& missing_positions = sequence_store.missing_symbol_bitmaps[row];
+      const auto missing_counted_positions =
+         static_cast<int32_t>(missing_positions.and_cardinality(positions_counting_missing_rows));
+      const auto missing_compared_positions =
+         static_cast<int32_t>(missing_positions.and_cardinality(compared_positions));
+      neighbors.push_back(
+         {regular_position_count + counters[row] - missing_counted_positions,
+          compared_position_count - missing_compared_positions,
+          partition_id,
+          row}
+      );
+   }
+   if (neighbors.size() > k) {
+      std::partial_sort(neighbors.begin(), neighbors.begin() + k, neighbors.end());
+      neighbors.resize(k);
+   }
+   return neighbors;
+}
+
+}  // namespace
+
+template <typename SymbolType>
+NearestSequences<SymbolType>::NearestSequences(
+   std::optional<std::string> sequence_name,
+   std::optional<std::string> query_sequence,
+   std::vector<std::string>&& mutations,
+   uint32_t k
+)
+    : sequence_name(std::move(sequence_name)),
+      query_sequence(std::move(query_sequence)),
+      mutations(std::move(mutations)),
+      k(k) {}
+
+template <typename SymbolType>
+std::vector<std::optional<typename SymbolType::Symbol>> NearestSequences<
+   SymbolType>::getQuerySymbols(const std::vector<typename SymbolType::Symbol>& reference_sequence
+) const {
+   std::vector<typename SymbolType::Symbol> symbols;
+   if (query_sequence.has_value()) {
+      CHECK_SILO_QUERY(
+         query_sequence->size() == reference_sequence.size(),
+         fmt::format(
+            "The sequence of the NearestSequences action must be aligned to the reference, "
+            "which has length {}, but it has length {}",
+            reference_sequence.size(),
+            query_sequence->size()
+         )
+      )
+      symbols.reserve(query_sequence->size());
+      for (const char character : *query_sequence) {
+         const auto symbol = SymbolType::charToSymbol(character);
+         CHECK_SILO_QUERY(
+            symbol.has_value(),
+            fmt::format(
+               "The sequence of the NearestSequences action contains the illegal {} symbol '{}'",
+               SymbolType::SYMBOL_NAME_LOWER_CASE,
+               character
+            )
+         )
+         symbols.push_back(*symbol);
+      }
+   } else {
+      symbols = reference_sequence;
+      for (const auto& mutation : mutations) {
+         const auto parsed_mutation =
+            ParsedMutation<SymbolType>::parse(mutation, reference_sequence);
+         symbols[parsed_mutation.position_idx] = parsed_mutation.symbol;
+      }
+   }
+
+   // Missing and ambiguous query symbols are not compared
+   std::vector<std::optional<typename SymbolType::Symbol>> query_symbols(symbols.size());
+   for (size_t position_idx = 0; position_idx < symbols.size(); ++position_idx) {
+      const auto symbol = symbols[position_idx];
+      if (std::find(
+             SymbolType::VALID_MUTATION_SYMBOLS.begin(),
+             SymbolType::VALID_MUTATION_SYMBOLS.end(),
+             symbol
+          ) != SymbolType::VALID_MUTATION_SYMBOLS.end()) {
+         query_symbols[position_idx] = symbol;
+      }
+   }
+   return query_symbols;
+}
+
+template <typename SymbolType>
+void NearestSequences<SymbolType>::validateOrderByFields(const Database& database) const {
+   const std::vector<std::string> result_field_names{
+      {database.database_config.schema.primary_key,
+       DISTANCE_FIELD_NAME,
+       COMPARED_POSITIONS_FIELD_NAME}
+   };
+
+   for (const OrderByField& field : order_by_fields) {
+      CHECK_SILO_QUERY(
+         std::any_of(
+            result_field_names.begin(),
+            result_field_names.end(),
+            [&](const std::string& result_field) { return result_field == field.name; }
+         ),
+         fmt::format(
+            "OrderByField {} is not contained in the result of this operation. "
+            "Allowed values are {}.",
+            field.name,
+            fmt::join(result_field_names, ", ")
+         )
+      )
+   }
+}
+
+template <typename SymbolType>
+QueryResult NearestSequences<SymbolType>::execute(
+   const Database& database,
+   std::vector<OperatorResult> bitmap_filter
+) const {
+   CHECK_SILO_QUERY(
+      sequence_name.has_value() || database.getDefaultSequenceName<SymbolType>().has_value(),
+      fmt::format(
+         "Database does not have a default sequence name for {} Sequences", SymbolType::SYMBOL_NAME
+      )
+   )
+   const std::string sequence_name_or_default =
+      sequence_name.value_or(database.getDefaultSequenceName<SymbolType>().value_or(""));
+   CHECK_SILO_QUERY(
+      database.getSequenceStores<SymbolType>().contains(sequence_name_or_default),
+      "Database does not contain the " + std::string(SymbolType::SYMBOL_NAME_LOWER_CASE) +
+         " sequence with name: '" + sequence_name_or_default + "'"
+   )
+   const auto query_symbols = getQuerySymbols(
+      database.getSequenceStores<SymbolType>().at(sequence_name_or_default).reference_sequence
+   );
+
+   std::vector<std::vector<Neighbor>> neighbors_per_partition(database.partitions.size());
+   tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, database.partitions.size()),
+      [&](const auto& local) {
+         for (size_t partition_id = local.begin(); partition_id != local.end(); ++partition_id) {
+            const roaring::Roaring& filter = *bitmap_filter[partition_id];
+            if (filter.isEmpty()) {
+               continue;
+            }
+            neighbors_per_partition[partition_id] = findNearestInPartition<SymbolType>(
+               database.partitions[partition_id].getSequenceStores<SymbolType>().at(
+                  sequence_name_or_default
+               ),
+               query_symbols,
+               filter,
+               partition_id,
+               k
+            );
+         }
+      }
+   );
+
+   std::vector<Neighbor> neighbors;
+   for (const auto& partition_neighbors : neighbors_per_partition) {
+      neighbors.insert(neighbors.end(), partition_neighbors.begin(), partition_neighbors.end());
+   }
+   const size_t result_count = std::min<size_t>(neighbors.size(), k);
+   std::partial_sort(neighbors.begin(), neighbors.begin() + result_count, neighbors.end());
+   neighbors.resize(result_count);
+
+   const std::string& primary_key_column = database.database_config.schema.primary_key;
+   std::vector<QueryResultEntry> result;
+   result.reserve(neighbors.size());
+   for (const auto& neighbor : neighbors) {
+      const std::map<std::string, common::JsonValueType> fields{
+         {primary_key_column,
+          database.partitions[neighbor.partition_id].columns.getValue(
+             primary_key_column, neighbor.row
+          )},
+         {DISTANCE_FIELD_NAME, neighbor.distance},
+         {COMPARED_POSITIONS_FIELD_NAME, neighbor.compared_positions}
+      };
+      result.push_back({fields});
+   }
+   return {result};
+}
+
+template <typename SymbolType>
+// NOLINTNEXTLINE(readability-identifier-naming)
+void from_json(const nlohmann::json& json, std::unique_ptr<NearestSequences<SymbolType>>& action) {
+   CHECK_SILO_QUERY(
+      !json.contains("sequenceName") || json["sequenceName"].is_string(),
+      "NearestSequences action can have the field sequenceName of type string, but no other type"
+   )
+   std::optional<std::string> sequence_name;
+   if (json.contains("sequenceName")) {
+      sequence_name = json["sequenceName"].get<std::string>();
+   }
+
+   CHECK_SILO_QUERY(
+      json.contains("sequence") != json.contains("mutations"),
+      "NearestSequences action must contain either the field sequence or the field mutations"
+   )
+   std::optional<std::string> query_sequence;
+   if (json.contains("sequence")) {
+      CHECK_SILO_QUERY(
+         json["sequence"].is_string(),
+         "The field sequence of the NearestSequences action must be a string"
+      )
+      query_sequence = json["sequence"].get<std::string>();
+   }
+   std::vector<std::string> mutations;
+   if (json.contains("mutations")) {
+      CHECK_SILO_QUERY(
+         json["mutations"].is_array(),
+         "The field mutations of the NearestSequences action must be an array of strings"
+      )
+      for (const auto& child : json["mutations"]) {
+         CHECK_SILO_QUERY(
+            child.is_string(),
+            "The field mutations of the NearestSequences action must be an array of strings. "
+            "Found:" +
+               child.dump()
+         )
+         mutations.emplace_back(child.get<std::string>());
+      }
+   }
+
+   CHECK_SILO_QUERY(
+      !json.contains("k") ||
+         (json["k"].is_number_unsigned() && json["k"].get<uint64_t>() > 0 &&
+          json["k"].get<uint64_t>() <= NearestSequences<SymbolType>::K_LIMIT),
+      fmt::format(
+         "The field k of the NearestSequences action must be a number in [1, {}]",
+         NearestSequences<SymbolType>::K_LIMIT
+      )
+   )
+   const auto k = json.value("k", NearestSequences<SymbolType>::DEFAULT_K);
+
+   action = std::make_unique<NearestSequences<SymbolType>>(
+      std::move(sequence_name), std::move(query_sequence), std::move(mutations), k
+   );
+}
+
+template class NearestSequences<AminoAcid>;
+template class NearestSequences<Nucleotide>;
+// NOLINTNEXTLINE(readability-identifier-naming)
+template void from_json<AminoAcid>(
+   const nlohmann::json& json,
+   std::unique_ptr<NearestSequences<AminoAcid>>& action
+);
+// NOLINTNEXTLINE(readability-identifier-naming)
+template void from_json<Nucleotide>(
+   const nlohmann::json& json,
+   std::unique_ptr<NearestSequences<Nucleotide>>& action
+);
+
+}  // namespace silo::query_engine::actions
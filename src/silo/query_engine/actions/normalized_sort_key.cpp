@@ -0,0 +1,215 @@
+#include "silo/query_engine/actions/normalized_sort_key.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <utility>
+
+#include "silo/config/database_config.h"
+#include "silo/database.h"
+#include "silo/query_engine/actions/action.h"
+
+namespace {
+
+using silo::config::ColumnType;
+
+constexpr uint32_t INT_SIGN_BIT = 1U << 31;
+constexpr uint64_t DOUBLE_SIGN_BIT = 1ULL << 63;
+constexpr uint32_t BITS_PER_WORD = 64;
+
+std::optional<uint32_t> getEncodedBits(ColumnType column_type) {
+   switch (column_type) {
+      case ColumnType::DATE:
+      case ColumnType::INT:
+      case ColumnType::INDEXED_STRING:
+      case ColumnType::INDEXED_PANGOLINEAGE:
+         return 32;
+      case ColumnType::FLOAT:
+         return 64;
+      case ColumnType::BOOL:
+         return 2;
+      case ColumnType::STRING:
+      case ColumnType::NUC_INSERTION:
+      case ColumnType::AA_INSERTION:
+         return std::nullopt;
+   }
+   return std::nullopt;
+}
+
+/// Ranks the values that occur in the partitions of the column by their string order
+std::vector<uint32_t> getValueRanks(
+   const silo::Database& database,
+   const silo::storage::ColumnMetadata& metadata
+) {
+   std::unordered_set<silo::Idx> seen_value_ids;
+   std::vector<std::pair<std::string, silo::Idx>> values;
+   silo::Idx max_value_id = 0;
+   for (const auto& partition : database.partitions) {
+      if (metadata.type == ColumnType::INDEXED_PANGOLINEAGE) {
+         const auto& column = partition.columns.pango_lineage_columns.at(metadata.name);
+         for (const auto& [value_id, bitmap] : column.getValueBitmaps()) {
+            if (seen_value_ids.insert(value_id).second) {
+               values.emplace_back(column.lookupAliasedValue(value_id).value, value_id);
+            }
+         }
+      } else {
+         const auto& column = partition.columns.indexed_string_columns.at(metadata.name);
+         for (const auto& [value_id, bitmap] : column.getValueBitmaps()) {
+            if (seen_value_ids.insert(value_id).second) {
+               values.emplace_back(column.lookupValue(value_id), value_id);
+            }
+         }
+      }
+   }
+   std::sort(values.begin(), values.end());
+
+   for (const auto& [value, value_id] : values) {
+      max_value_id = std::max(max_value_id, value_id);
+   }
+   std::vector<uint32_t> value_ranks(values.empty() ? 0 : max_value_id + 1);
+   uint32_t rank = 0;
+   for (size_t index = 0; index < values.size(); ++index) {
+      if (index > 0 && values[index].first != values[index - 1].first) {
+         ++rank;
+      }
+      value_ranks[values[index].second] = rank;
+   }
+   return value_ranks;
+}
+
+/// Orders like OptionalBool: null < false < true
+uint64_t encodeBool(silo::common::OptionalBool value) {
+   if (value.isNull()) {
+      return 0;
+   }
+   return value.value().value() ? 2 : 1;
+}
+
+uint64_t bitMask(uint32_t bits) {
+   return bits == BITS_PER_WORD ? UINT64_MAX : (1ULL << bits) - 1;
+}
+
+void appendBits(silo::query_engine::actions::NormalizedSortKey& key, uint64_t code, uint32_t bits) {
+   if (bits == BITS_PER_WORD) {
+      key.high = key.low;
+      key.low = code;
+      return;
+   }
+   key.high = (key.high << bits) | (key.low >> (BITS_PER_WORD - bits));
+   key.low = (key.low << bits) | code;
+}
+
+}  // namespace
+
+namespace silo::query_engine::actions {
+
+uint64_t encodeDouble(double value) {
+   if (std::isnan(value)) {
+      return UINT64_MAX;
+   }
+   if (value == 0.0) {
+      value = 0.0;
+   }
+   const auto bits = std::bit_cast<uint64_t>(value);
+   return (bits & DOUBLE_SIGN_BIT) != 0 ? ~bits : bits | DOUBLE_SIGN_BIT;
+}
+
+std::optional<NormalizedSortKeyEncoding> NormalizedSortKeyEncoding::create(
+   const Database& database,
+   const std::vector<OrderByField>& order_by_fields
+) {
+   NormalizedSortKeyEncoding encoding;
+   uint32_t total_bits = 0;
+   for (const OrderByField& order_by_field : order_by_fields) {
+      const auto& metadata = database.database_config.getMetadata(order_by_field.name);
+      if (!metadata.has_value()) {
+         return std::nullopt;
+      }
+      const ColumnType column_type = metadata->getColumnType();
+      const std::optional<uint32_t> bits = getEncodedBits(column_type);
+      if (!bits.has_value() || total_bits + bits.value() > MAX_BITS) {
+         return std::nullopt;
+      }
+      total_bits += bits.value();
+      Field field{
+         .metadata = {metadata->name, column_type},
+         .ascending = order_by_field.ascending,
+         .bits = bits.value(),
+         .value_ranks = {}
+      };
+      if (column_type == ColumnType::INDEXED_STRING ||
+          column_type == ColumnType::INDEXED_PANGOLINEAGE) {
+         field.value_ranks = getValueRanks(database, field.metadata);
+      }
+      encoding.fields.push_back(std::move(field));
+   }
+   return encoding;
+}
+
+NormalizedSortKeyFactory::NormalizedSortKeyFactory(
+   const NormalizedSortKeyEncoding& encoding,
+   const silo::storage::ColumnPartitionGroup& columns
+) {
+   for (const auto& field : encoding.fields) {
+      FieldValues values{.field = &field};
+      const std::string& name = field.metadata.name;
+      if (field.metadata.type == ColumnType::DATE) {
+         values.dates = columns.date_columns.at(name).getValues().data();
+      } else if (field.metadata.type == ColumnType::INT) {
+         values.ints = columns.int_columns.at(name).getValues().data();
+      } else if (field.metadata.type == ColumnType::FLOAT) {
+         values.floats = columns.float_columns.at(name).getValues().data();
+      } else if (field.metadata.type == ColumnType::BOOL) {
+         values.bools = columns.bool_columns.at(name).getValues().data();
+      } else if (field.metadata.type == ColumnType::INDEXED_STRING) {
+         values.value_ids = columns.indexed_string_columns.at(name).getValues().data();
+      } else if (field.metadata.type == ColumnType::INDEXED_PANGOLINEAGE) {
+         values.value_ids = columns.pango_lineage_columns.at(name).getValues().data();
+      } else {
+         throw std::runtime_error("Unchecked column type of column " + name);
+      }
+      field_values.push_back(values);
+   }
+}
+
+NormalizedSortKey NormalizedSortKeyFactory::allocateOne(uint32_t sequence_id) const {
+   NormalizedSortKey key;
+   overwrite(key, sequence_id);
+   return key;
+}
+
+NormalizedSortKey& NormalizedSortKeyFactory::overwrite(
+   NormalizedSortKey& key,
+   uint32_t sequence_id
+) const {
+   key = {};
+   for (const FieldValues& values : field_values) {
+      const ColumnType column_type = values.field->metadata.type;
+      uint64_t code;
+      if (column_type == ColumnType::DATE) {
+         code = values.dates[sequence_id];
+      } else if (column_type == ColumnType::INT) {
+         code = static_cast<uint32_t>(values.ints[sequence_id]) ^ INT_SIGN_BIT;
+      } else if (column_type == ColumnType::FLOAT) {
+         code = encodeDouble(values.floats[sequence_id]);
+      } else if (column_type == ColumnType::BOOL) {
+         code = encodeBool(values.bools[sequence_id]);
+      } else {
+         code = values.field->value_ranks[values.value_ids[sequence_id]];
+      }
+      if (!values.field->ascending) {
+         code = ~code & bitMask(values.field->bits);
+      }
+      appendBits(key, code, values.field->bits);
+   }
+   return key;
+}
+
+std::vector<NormalizedSortKey> NormalizedSortKeyFactory::allocateMany(size_t count) const {
+   return std::vector<NormalizedSortKey>(count);
+}
+
+}  // namespace silo::query_engine::actions
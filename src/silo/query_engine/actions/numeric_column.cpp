@@ -0,0 +1,83 @@
+#include "silo/query_engine/actions/numeric_column.h"
+
+#include <cmath>
+
+#include "silo/config/database_config.h"
+#include "silo/database.h"
+#include "silo/query_engine/query_parse_exception.h"
+
+namespace silo::query_engine::actions {
+
+using silo::config::ColumnType;
+
+NumericColumn::NumericColumn(
+   const silo::storage::ColumnPartitionGroup& columns,
+   const silo::storage::ColumnMetadata& metadata
+) {
+   if (metadata.type == ColumnType::INT) {
+      int_values = &columns.int_columns.at(metadata.name).getValues();
+   } else if (metadata.type == ColumnType::FLOAT) {
+      float_values = &columns.float_columns.at(metadata.name).getValues();
+   } else {
+      date_values = &columns.date_columns.at(metadata.name).getValues();
+   }
+}
+
+std::optional<double> NumericColumn::getValue(uint32_t row) const {
+   if (int_values != nullptr) {
+      const int32_t value = (*int_values)[row];
+      if (value == INT32_MIN) {
+         return std::nullopt;
+      }
+      return value;
+   }
+   if (float_values != nullptr) {
+      const double value = (*float_values)[row];
+      if (std::isnan(value)) {
+         return std::nullopt;
+      }
+      return value;
+   }
+   const common::Date value = (*date_values)[row];
+   if (value == common::NULL_DATE) {
+      return std::nullopt;
+   }
+   return common::dateToDays(value);
+}
+
+silo::storage::ColumnMetadata getNumericColumnMetadata(
+   const Database& database,
+   const std::string& field,
+   const std::string& action_name
+) {
+   const auto& metadata = database.database_config.getMetadata(field);
+   CHECK_SILO_QUERY(
+      metadata.has_value(),
+      "Metadata field '" + field + "' of the " + action_name + " action not found"
+   )
+   const ColumnType column_type = metadata->getColumnType();
+   CHECK_SILO_QUERY(
+      column_type == ColumnType::INT || column_type == ColumnType::FLOAT ||
+         column_type == ColumnType::DATE,
+      "The " + action_name + " action can only be applied to int, float or date fields, but '" +
+         field + "' is not"
+   )
+   return {metadata->name, column_type};
+}
+
+common::JsonValueType numericValueToJson(double value, ColumnType column_type) {
+   if (column_type == ColumnType::INT) {
+      return static_cast<int32_t>(value);
+   }
+   if (column_type == ColumnType::DATE) {
+      const auto date_string =
+         common::dateToString(common::daysToDate(static_cast<int32_t>(value)));
+      if (!date_string.has_value()) {
+         return std::nullopt;
+      }
+      return date_string.value();
+   }
+   return value;
+}
+
+}  // namespace silo::query_engine::actions
@@ -0,0 +1,99 @@
+#include "silo/query_engine/actions/parsed_mutation.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstddef>
+#include <system_error>
+
+#include <fmt/format.h>
+
+#include "silo/common/aa_symbols.h"
+#include "silo/common/nucleotide_symbols.h"
+#include "silo/query_engine/filter_expressions/expression.h"
+#include "silo/query_engine/filter_expressions/symbol_equals.h"
+#include "silo/query_engine/operator_result.h"
+#include "silo/query_engine/operators/operator.h"
+#include "silo/query_engine/query_parse_exception.h"
+
+using silo::query_engine::filter_expressions::Expression;
+using silo::query_engine::filter_expressions::SymbolEquals;
+
+namespace silo::query_engine::actions {
+
+template <typename SymbolType>
+ParsedMutation<SymbolType> ParsedMutation<SymbolType>::parse(
+   const std::string& mutation,
+   const std::vector<typename SymbolType::Symbol>& reference_sequence
+) {
+   const size_t position_begin =
+      !mutation.empty() && std::isdigit(static_cast<unsigned char>(mutation.front())) == 0 ? 1
+                                                                                          : 0;
+   const size_t position_end = mutation.empty() ? 0 : mutation.size() - 1;
+   const bool is_well_formed =
+      position_begin < position_end &&
+      std::all_of(
+         mutation.begin() + static_cast<std::ptrdiff_t>(position_begin),
+         mutation.begin() + static_cast<std::ptrdiff_t>(position_end),
+         [](char character) { return std::isdigit(static_cast<unsigned char>(character)) != 0; }
+      );
+   CHECK_SILO_QUERY(
+      is_well_formed,
+      fmt::format(
+         "The mutation '{}' must consist of an optional reference symbol, a position and a "
+         "symbol, e.g. C241T",
+         mutation
+      )
+   )
+   uint32_t position = 0;
+   const char* const digits_end = mutation.data() + position_end;
+   const auto [parsed_end, error] =
+      std::from_chars(mutation.data() + position_begin, digits_end, position);
+   CHECK_SILO_QUERY(
+      error == std::errc() && parsed_end == digits_end && position > 0 &&
+         position <= reference_sequence.size(),
+      fmt::format(
+         "The position of the mutation '{}' is out of bounds [1, {}]",
+         mutation,
+         reference_sequence.size()
+      )
+   )
+   const auto symbol = SymbolType::charToSymbol(mutation.back());
+   CHECK_SILO_QUERY(
+      symbol.has_value(),
+      fmt::format(
+         "The mutation '{}' does not end with a valid {} symbol",
+         mutation,
+         SymbolType::SYMBOL_NAME_LOWER_CASE
+      )
+   )
+   const uint32_t position_idx = position - 1;
+   return ParsedMutation<SymbolType>{
+      .position_idx = position_idx,
+      .symbol = *symbol,
+      .name = fmt::format(
+         "{}{}{}",
+         SymbolType::symbolToChar(reference_sequence.at(position_idx)),
+         position,
+         SymbolType::symbolToChar(*symbol)
+      )
+   };
+}
+
+template <typename SymbolType>
+roaring::Roaring ParsedMutation<SymbolType>::getRowsWithMutation(
+   const Database& database,
+   const DatabasePartition& database_partition,
+   const std::string& sequence_name,
+   const roaring::Roaring& filter
+) const {
+   const SymbolEquals<SymbolType> symbol_equals(sequence_name, position_idx, symbol);
+   const OperatorResult rows_with_symbol =
+      symbol_equals.compile(database, database_partition, Expression::NONE)->evaluate();
+   return *rows_with_symbol & filter;
+}
+
+template struct ParsedMutation<AminoAcid>;
+template struct ParsedMutation<Nucleotide>;
+
+}  // namespace silo::query_engine::actions
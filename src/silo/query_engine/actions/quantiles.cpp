@@ -0,0 +1,137 @@
+#include "silo/query_engine/actions/quantiles.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <utility>
+
+#include <fmt/format.h>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <nlohmann/json.hpp>
+#include <roaring/roaring.hh>
+
+#include "silo/database.h"
+#include "silo/query_engine/actions/action.h"
+#include "silo/query_engine/actions/numeric_column.h"
+#include "silo/query_engine/operator_result.h"
+#include "silo/query_engine/query_parse_exception.h"
+#include "silo/query_engine/query_result.h"
+#include "silo/storage/database_partition.h"
+
+namespace silo::query_engine::actions {
+
+Quantiles::Quantiles(std::string field, std::vector<double> quantiles)
+    : field(std::move(field)),
+      quantiles(std::move(quantiles)) {}
+
+void Quantiles::validateOrderByFields(const Database& /*database*/) const {
+   const std::vector<std::string> result_field_names{{QUANTILE_FIELD_NAME, VALUE_FIELD_NAME}};
+
+   for (const OrderByField& field : order_by_fields) {
+      CHECK_SILO_QUERY(
+         std::any_of(
+            result_field_names.begin(),
+            result_field_names.end(),
+            [&](const std::string& result_field) { return result_field == field.name; }
+         ),
+         fmt::format(
+            "OrderByField {} is not contained in the result of this operation. "
+            "Allowed values are {}.",
+            field.name,
+            fmt::join(result_field_names, ", ")
+         )
+      )
+   }
+}
+
+QueryResult Quantiles::execute(const Database& database, std::vector<OperatorResult> bitmap_filter)
+   const {
+   const storage::ColumnMetadata metadata = getNumericColumnMetadata(database, field, "Quantiles");
+
+   std::vector<std::vector<double>> values_per_partition(database.partitions.size());
+   tbb::parallel_for(
+      tbb::blocked_range<size_t>(0, database.partitions.size()),
+      [&](const tbb::blocked_range<size_t>& local) {
+         for (size_t partition_id = local.begin(); partition_id != local.end(); ++partition_id) {
+            const NumericColumn column(database.partitions[partition_id].columns, metadata);
+            const roaring::Roaring& rows = *bitmap_filter[partition_id];
+            auto& values = values_per_partition[partition_id];
+            values.reserve(rows.cardinality());
+            for (const uint32_t row : rows) {
+               const auto value = column.getValue(row);
+               if (value.has_value()) {
+                  values.push_back(*value);
+               }
+            }
+         }
+      }
+   );
+   std::vector<double> values;
+   for (auto& partition_values : values_per_partition) {
+      values.insert(values.end(), partition_values.begin(), partition_values.end());
+      partition_values = {};
+   }
+
+   // Selecting the ranks in ascending order only leaves the values above the last rank to
+   // partition for the next one
+   std::vector<std::pair<double, size_t>> quantile_ranks;
+   for (const double quantile : quantiles) {
+      const auto rank = static_cast<size_t>(
+         std::max(0.0, std::ceil(quantile * static_cast<double>(values.size())) - 1)
+      );
+      quantile_ranks.emplace_back(quantile, rank);
+   }
+   std::sort(quantile_ranks.begin(), quantile_ranks.end(), [](const auto& left, const auto& right) {
+      return left.second < right.second;
+   });
+   std::map<double, common::JsonValueType> value_per_quantile;
+   auto unpartitioned_begin = values.begin();
+   for (const auto& [quantile, rank] : quantile_ranks) {
+      if (values.empty()) {
+         value_per_quantile[quantile] = std::nullopt;
+         continue;
+      }
+      const auto nth = values.begin() + static_cast<int64_t>(rank);
+      if (nth >= unpartitioned_begin) {
+         std::nth_element(unpartitioned_begin, nth, values.end());
+         unpartitioned_begin = nth + 1;
+      }
+      value_per_quantile[quantile] = numericValueToJson(*nth, metadata.type);
+   }
+
+   std::vector<QueryResultEntry> result;
+   for (const double quantile : quantiles) {
+      const std::map<std::string, common::JsonValueType> fields{
+         {QUANTILE_FIELD_NAME, quantile}, {VALUE_FIELD_NAME, value_per_quantile.at(quantile)}
+      };
+      result.push_back({fields});
+   }
+   return {result};
+}
+
+// NOLINTNEXTLINE(readability-identifier-naming)
+void from_json(const nlohmann::json& json, std::unique_ptr<Quantiles>& action) {
+   CHECK_SILO_QUERY(
+      json.contains("field") && json["field"].is_string(),
+      "Quantiles action must contain the field field of type string"
+   )
+   CHECK_SILO_QUERY(
+      json.contains("quantiles") && json["quantiles"].is_array() && !json["quantiles"].empty(),
+      "Quantiles action must contain the field quantiles of type non-empty array of numbers"
+   )
+   std::vector<double> quantiles;
+   for (const auto& child : json["quantiles"]) {
+      CHECK_SILO_QUERY(
+         child.is_number() && child.get<double>() >= 0 && child.get<double>() <= 1,
+         "The quantiles of the Quantiles action must be numbers in the interval [0.0, 1.0]. "
+         "Found:" +
+            child.dump()
+      )
+      quantiles.push_back(child.get<double>());
+   }
+   action = std::make_unique<Quantiles>(json["field"].get<std::string>(), std::move(quantiles));
+}
+
+}  // namespace silo::query_engine::actions
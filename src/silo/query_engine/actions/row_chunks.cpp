@@ -0,0 +1,51 @@
+#include "silo/query_engine/actions/row_chunks.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace silo::query_engine::actions {
+
+RowChunks::RowChunks(
+   std::vector<OperatorResult> bitmap_filter,
+   size_t offset,
+   std::optional<size_t> limit,
+   size_t chunk_size
+)
+    : bitmap_filter(std::move(bitmap_filter)),
+      chunk_size(chunk_size),
+      rank_in_partition(offset) {
+   size_t total_count = 0;
+   for (const auto& bitmap : this->bitmap_filter) {
+      total_count += bitmap->cardinality();
+   }
+   remaining_count = total_count > offset ? total_count - offset : 0;
+   if (limit.has_value()) {
+      remaining_count = std::min(remaining_count, limit.value());
+   }
+}
+
+size_t RowChunks::remainingCount() const {
+   return remaining_count;
+}
+
+std::optional<RowChunks::Chunk> RowChunks::next() {
+   while (remaining_count > 0 && partition_id < bitmap_filter.size()) {
+      const auto& bitmap = bitmap_filter[partition_id];
+      const size_t cardinality = bitmap->cardinality();
+      if (rank_in_partition >= cardinality) {
+         rank_in_partition -= cardinality;
+         ++partition_id;
+         continue;
+      }
+      const size_t count =
+         std::min({chunk_size, cardinality - rank_in_partition, remaining_count});
+      Chunk chunk{.partition_id = partition_id, .row_ids = std::vector<uint32_t>(count)};
+      bitmap->rangeUint32Array(chunk.row_ids.data(), rank_in_partition, count);
+      rank_in_partition += count;
+      remaining_count -= count;
+      return chunk;
+   }
+   return std::nullopt;
+}
+
+}  // namespace silo::query_engine::actions
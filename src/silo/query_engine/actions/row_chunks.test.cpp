@@ -0,0 +1,57 @@
+#include "silo/query_engine/actions/row_chunks.h"
+
+#include <gtest/gtest.h>
+#include <roaring/roaring.hh>
+
+using silo::query_engine::OperatorResult;
+using silo::query_engine::actions::RowChunks;
+
+namespace {
+
+std::vector<OperatorResult> createBitmapFilter() {
+   std::vector<OperatorResult> bitmap_filter;
+   bitmap_filter.emplace_back(roaring::Roaring{1, 3, 5});
+   bitmap_filter.emplace_back(roaring::Roaring{});
+   bitmap_filter.emplace_back(roaring::Roaring{0, 2, 4, 6});
+   return bitmap_filter;
+}
+
+}  // namespace
+
+TEST(RowChunks, splitsRowsIntoChunksOfSinglePartitions) {
+   RowChunks row_chunks(createBitmapFilter(), 0, std::nullopt, 2);
+   EXPECT_EQ(row_chunks.remainingCount(), 7);
+
+   std::vector<std::pair<size_t, std::vector<uint32_t>>> chunks;
+   while (auto chunk = row_chunks.next()) {
+      chunks.emplace_back(chunk->partition_id, chunk->row_ids);
+   }
+   const std::vector<std::pair<size_t, std::vector<uint32_t>>> expected{
+      {0, {1, 3}}, {0, {5}}, {2, {0, 2}}, {2, {4, 6}}
+   };
+   EXPECT_EQ(chunks, expected);
+   EXPECT_EQ(row_chunks.remainingCount(), 0);
+}
+
+TEST(RowChunks, appliesOffsetAndLimit) {
+   RowChunks row_chunks(createBitmapFilter(), 2, 3, 10);
+   EXPECT_EQ(row_chunks.remainingCount(), 3);
+
+   const auto first = row_chunks.next();
+   ASSERT_TRUE(first.has_value());
+   EXPECT_EQ(first->partition_id, 0);
+   EXPECT_EQ(first->row_ids, std::vector<uint32_t>({5}));
+
+   const auto second = row_chunks.next();
+   ASSERT_TRUE(second.has_value());
+   EXPECT_EQ(second->partition_id, 2);
+   EXPECT_EQ(second->row_ids, std::vector<uint32_t>({0, 2}));
+
+   EXPECT_FALSE(row_chunks.next().has_value());
+}
+
+TEST(RowChunks, isEmptyIfOffsetExceedsRows) {
+   RowChunks row_chunks(createBitmapFilter(), 7, std::nullopt, 10);
+   EXPECT_EQ(row_chunks.remainingCount(), 0);
+   EXPECT_FALSE(row_chunks.next().has_value());
+}
@@ -0,0 +1,180 @@
+#include "silo/query_engine/actions/symbol_counts.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <roaring/roaring.hh>
+
+#include "silo/common/aa_symbols.h"
+#include "silo/common/nucleotide_symbols.h"
+#include "silo/database.h"
+#include "silo/query_engine/operator_result.h"
+#include "silo/storage/database_partition.h"
+#include "silo/storage/sequence_store.h"
+
+using silo::query_engine::OperatorResult;
+
+namespace silo::query_engine::actions {
+
+template <typename SymbolType>
+std::unordered_map<std::string, PrefilteredBitmaps<SymbolType>> preFilterBitmaps(
+   const silo::Database& database,
+   std::vector<OperatorResult>& bitmap_filter
+) {
+   std::unordered_map<std::string, PrefilteredBitmaps<SymbolType>> bitmaps_to_evaluate;
+   for (size_t i = 0; i < database.partitions.size(); ++i) {
+      const DatabasePartition& database_partition = database.partitions.at(i);
+      OperatorResult& filter = bitmap_filter[i];
+      const size_t cardinality = filter->cardinality();
+      if (cardinality == 0) {
+         continue;
+      }
+      if (cardinality == database_partition.sequence_count) {
+         for (const auto& [sequence_name, sequence_store] :
+              database_partition.getSequenceStores<SymbolType>()) {
+            bitmaps_to_evaluate[sequence_name].full_bitmaps.emplace_back(filter, sequence_store);
+         }
+      } else {
+         if (filter.isMutable()) {
+            filter->runOptimize();
+         }
+         for (const auto& [sequence_name, sequence_store] :
+              database_partition.getSequenceStores<SymbolType>()) {
+            bitmaps_to_evaluate[sequence_name].bitmaps.emplace_back(filter, sequence_store);
+         }
+      }
+   }
+   return bitmaps_to_evaluate;
+}
+
+namespace {
+
+template <typename SymbolType>
+void addPositionToMutationCountsForMixedBitmaps(
+   uint32_t position_idx,
+   const PrefilteredBitmaps<SymbolType>& bitmaps_to_evaluate,
+   SymbolMap<SymbolType, std::vector<uint32_t>>& count_of_mutations_per_position
+) {
+   for (const auto& [filter, sequence_store_partition] : bitmaps_to_evaluate.bitmaps) {
+      for (const auto symbol : SymbolType::SYMBOLS) {
+         const auto& current_position = sequence_store_partition.positions[position_idx];
+         if (current_position.isSymbolDeleted(symbol)) {
+            count_of_mutations_per_position[symbol][position_idx] += filter->cardinality();
+            for (const uint32_t idx : *filter) {
+               const roaring::Roaring& n_bitmap =
+                  sequence_store_partition.missing_symbol_bitmaps[idx];
+               if (n_bitmap.contains(position_idx)) {
+                  count_of_mutations_per_position[symbol][position_idx] -= 1;
+               }
+            }
+            continue;
+         }
+         const uint32_t symbol_count =
+            current_position.isSymbolFlipped(symbol)
+               ? filter->andnot_cardinality(*current_position.getBitmap(symbol))
+               : filter->and_cardinality(*current_position.getBitmap(symbol));
+
+         count_of_mutations_per_position[symbol][position_idx] += symbol_count;
+
+         const auto deleted_symbol = current_position.getDeletedSymbol();
+         if (deleted_symbol.has_value() && symbol != *deleted_symbol) {
+            count_of_mutations_per_position[*deleted_symbol][position_idx] -= symbol_count;
+         }
+      }
+   }
+}
+
+template <typename SymbolType>
+void addPositionToMutationCountsForFullBitmaps(
+   uint32_t position_idx,
+   const PrefilteredBitmaps<SymbolType>& bitmaps_to_evaluate,
+   SymbolMap<SymbolType, std::vector<uint32_t>>& count_of_mutations_per_position
+) {
+   // For these partitions, we have full bitmaps. Do not need to bother with AND
+   // cardinality
+   for (const auto& [filter, sequence_store_partition] : bitmaps_to_evaluate.full_bitmaps) {
+      for (const auto symbol : SymbolType::SYMBOLS) {
+         const auto& current_position = sequence_store_partition.positions[position_idx];
+         if (current_position.isSymbolDeleted(symbol)) {
+            count_of_mutations_per_position[symbol][position_idx] +=
+               sequence_store_partition.sequence_count;
+            for (const roaring::Roaring& n_bitmap :
+                 sequence_store_partition.missing_symbol_bitmaps) {
+               if (n_bitmap.contains(position_idx)) {
+                  count_of_mutations_per_position[symbol][position_idx] -= 1;
+               }
+            }
+            continue;
+         }
+         const uint32_t symbol_count = current_position.isSymbolFlipped(symbol)
+                                          ? sequence_store_partition.sequence_count -
+                                               current_position.getBitmap(symbol)->cardinality()
+                                          : current_position.getBitmap(symbol)->cardinality();
+
+         count_of_mutations_per_position[symbol][position_idx] += symbol_count;
+
+         const auto deleted_symbol = current_position.getDeletedSymbol();
+         if (deleted_symbol.has_value() && symbol != *deleted_symbol) {
+            count_of_mutations_per_position[*deleted_symbol][position_idx] -=
+               sequence_store_partition.positions[position_idx].getBitmap(symbol)->cardinality();
+         }
+      }
+   }
+}
+
+}  // namespace
+
+template <typename SymbolType>
+SymbolMap<SymbolType, std::vector<uint32_t>> calculateMutationsPerPosition(
+   const SequenceStore<SymbolType>& sequence_store,
+   const PrefilteredBitmaps<SymbolType>& bitmap_filter
+) {
+   const size_t sequence_length = sequence_store.reference_sequence.size();
+
+   SymbolMap<SymbolType, std::vector<uint32_t>> mutation_counts_per_position;
+   for (const auto symbol : SymbolType::SYMBOLS) {
+      mutation_counts_per_position[symbol].resize(sequence_length);
+   }
+   static constexpr int POSITIONS_PER_PROCESS = 300;
+   tbb::parallel_for(
+      tbb::blocked_range<uint32_t>(0, sequence_length, /*grain_size=*/POSITIONS_PER_PROCESS),
+      [&](const auto& local) {
+         for (uint32_t pos = local.begin(); pos != local.end(); ++pos) {
+            addPositionToMutationCountsForMixedBitmaps(
+               pos, bitmap_filter, mutation_counts_per_position
+            );
+            addPositionToMutationCountsForFullBitmaps(
+               pos, bitmap_filter, mutation_counts_per_position
+            );
+         }
+      }
+   );
+   return mutation_counts_per_position;
+}
+
+template std::unordered_map<std::string, PrefilteredBitmaps<Nucleotide>>
+preFilterBitmaps<Nucleotide>(
+   const silo::Database& database,
+   std::vector<OperatorResult>& bitmap_filter
+);
+template std::unordered_map<std::string, PrefilteredBitmaps<AminoAcid>>
+preFilterBitmaps<AminoAcid>(
+   const silo::Database& database,
+   std::vector<OperatorResult>& bitmap_filter
+);
+
+template SymbolMap<Nucleotide, std::vector<uint32_t>> calculateMutationsPerPosition(
+   const SequenceStore<Nucleotide>& sequence_store,
+   const PrefilteredBitmaps<Nucleotide>& bitmap_filter
+);
+template SymbolMap<AminoAcid, std::vector<uint32_t>> calculateMutationsPerPosition(
+   const SequenceStore<AminoAcid>& sequence_store,
+   const PrefilteredBitmaps<AminoAcid>& bitmap_filter
+);
+
+}  // namespace silo::query_engine::actions
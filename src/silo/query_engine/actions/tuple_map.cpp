@@ -0,0 +1,138 @@
+#include "silo/query_engine/actions/tuple_map.h"
+
+#include <cstring>
+#include <string_view>
+#include <utility>
+
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+
+#include "silo/query_engine/actions/aggregate_function.h"
+
+namespace silo::query_engine::actions {
+
+namespace {
+
+constexpr size_t INITIAL_CAPACITY = 16;
+constexpr uint64_t EMPTY_SLOT = 0;
+
+}  // namespace
+
+template <typename Value>
+TupleMap<Value>::TupleMap(const TupleFactory& tuple_factory)
+    : columns(&tuple_factory.columns),
+      tuple_size(tuple_factory.tuple_size) {}
+
+template <typename Value>
+uint64_t TupleMap<Value>::hash(const std::byte* key) const {
+   const std::string_view str_view(reinterpret_cast<const char*>(key), tuple_size);
+   const uint64_t key_hash = std::hash<std::string_view>{}(str_view);
+   return key_hash == EMPTY_SLOT ? 1 : key_hash;
+}
+
+template <typename Value>
+void TupleMap<Value>::grow(Table& table) {
+   const size_t new_capacity = table.hashes.empty() ? INITIAL_CAPACITY : table.hashes.size() * 2;
+   Table new_table{
+      .hashes = std::vector<uint64_t>(new_capacity, EMPTY_SLOT),
+      .values = std::vector<Value>(new_capacity),
+      .keys = std::vector<std::byte>(new_capacity * tuple_size),
+   };
+   for (size_t slot = 0; slot < table.hashes.size(); ++slot) {
+      if (table.hashes[slot] != EMPTY_SLOT) {
+         findOrInsert(new_table, table.keys.data() + slot * tuple_size, table.hashes[slot]) =
+            std::move(table.values[slot]);
+      }
+   }
+   table = std::move(new_table);
+}
+
+template <typename Value>
+Value& TupleMap<Value>::findOrInsert(Table& table, const std::byte* key, uint64_t key_hash) {
+   // Keep the load factor below 0.75, linear probing degrades quickly above that
+   if ((table.size + 1) * 4 > table.hashes.size() * 3) {
+      grow(table);
+   }
+   const size_t mask = table.hashes.size() - 1;
+   size_t slot = key_hash & mask;
+   while (table.hashes[slot] != EMPTY_SLOT) {
+      if (table.hashes[slot] == key_hash &&
+          std::memcmp(table.keys.data() + slot * tuple_size, key, tuple_size) == 0) {
+         return table.values[slot];
+      }
+      slot = (slot + 1) & mask;
+   }
+   table.hashes[slot] = key_hash;
+   std::memcpy(table.keys.data() + slot * tuple_size, key, tuple_size);
+   ++table.size;
+   return table.values[slot];
+}
+
+template <typename Value>
+Value& TupleMap<Value>::operator[](const Tuple& tuple) {
+   const uint64_t tuple_hash = hash(tuple.data);
+   return findOrInsert(tables[tuple_hash >> (64 - RADIX_BITS)], tuple.data, tuple_hash);
+}
+
+template <typename Value>
+size_t TupleMap<Value>::size() const {
+   size_t size = 0;
+   for (const Table& table : tables) {
+      size += table.size;
+   }
+   return size;
+}
+
+template <typename Value>
+TupleMap<Value> TupleMap<Value>::merge(
+   const TupleFactory& tuple_factory,
+   std::vector<TupleMap>& maps
+) {
+   TupleMap result(tuple_factory);
+   tbb::parallel_for(
+      tbb::blocked_range<uint32_t>(0, RADIX_PARTITION_COUNT),
+      [&](const tbb::blocked_range<uint32_t>& range) {
+         for (uint32_t radix_partition = range.begin(); radix_partition != range.end();
+              ++radix_partition) {
+            Table& target = result.tables[radix_partition];
+            for (TupleMap& map : maps) {
+               Table& source = map.tables[radix_partition];
+               if (target.size == 0 && source.size != 0) {
+                  target = std::move(source);
+                  source = Table{};
+                  continue;
+               }
+               for (size_t slot = 0; slot < source.hashes.size(); ++slot) {
+                  if (source.hashes[slot] != EMPTY_SLOT) {
+                     result.findOrInsert(
+                        target,
+                        source.keys.data() + slot * result.tuple_size,
+                        source.hashes[slot]
+                     ) += std::move(source.values[slot]);
+                  }
+               }
+            }
+         }
+      }
+   );
+   return result;
+}
+
+template <typename Value>
+void TupleMap<Value>::forEachInRadixPartition(
+   uint32_t radix_partition,
+   const std::function<void(const Tuple&, Value&)>& function
+) {
+   Table& table = tables.at(radix_partition);
+   for (size_t slot = 0; slot < table.hashes.size(); ++slot) {
+      if (table.hashes[slot] != EMPTY_SLOT) {
+         const Tuple tuple(columns, table.keys.data() + slot * tuple_size, tuple_size);
+         function(tuple, table.values[slot]);
+      }
+   }
+}
+
+template class TupleMap<uint32_t>;
+template class TupleMap<GroupAggregates>;
+
+}  // namespace silo::query_engine::actions
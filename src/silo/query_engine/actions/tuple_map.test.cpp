@@ -0,0 +1,94 @@
+#include "silo/query_engine/actions/tuple_map.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "silo/config/database_config.h"
+#include "silo/storage/column/int_column.h"
+
+using silo::query_engine::actions::Tuple;
+using silo::query_engine::actions::TupleCountMap;
+using silo::query_engine::actions::TupleFactory;
+
+namespace {
+
+const std::string INT_COLUMN_NAME = "dummy_int_column";
+
+std::pair<silo::storage::ColumnGroup, silo::storage::ColumnPartitionGroup> createIntColumn(
+   const std::vector<int32_t>& values
+) {
+   std::pair<silo::storage::ColumnGroup, silo::storage::ColumnPartitionGroup> return_value;
+   auto& group = return_value.first;
+   auto& partition_group = return_value.second;
+
+   partition_group.metadata.push_back({INT_COLUMN_NAME, silo::config::ColumnType::INT});
+   group.int_columns.emplace(INT_COLUMN_NAME, silo::storage::column::IntColumn());
+   partition_group.int_columns.emplace(
+      INT_COLUMN_NAME, group.int_columns.at(INT_COLUMN_NAME).createPartition()
+   );
+   for (const int32_t value : values) {
+      partition_group.int_columns.at(INT_COLUMN_NAME).insert(std::to_string(value));
+   }
+   return return_value;
+}
+
+void countAllRows(TupleFactory& factory, TupleCountMap& map, size_t row_count) {
+   std::vector<Tuple> tuples = factory.allocateMany(1);
+   for (uint32_t row = 0; row < row_count; ++row) {
+      factory.overwrite(tuples.front(), row);
+      ++map[tuples.front()];
+   }
+}
+
+std::map<int32_t, uint32_t> toStdMap(TupleCountMap& map) {
+   std::map<int32_t, uint32_t> result;
+   for (uint32_t radix_partition = 0; radix_partition < TupleCountMap::RADIX_PARTITION_COUNT;
+        ++radix_partition) {
+      map.forEachInRadixPartition(radix_partition, [&](const Tuple& tuple, uint32_t& count) {
+         const auto value = tuple.getFields().at(INT_COLUMN_NAME);
+         EXPECT_FALSE(result.contains(std::get<int32_t>(value.value())));
+         result[std::get<int32_t>(value.value())] = count;
+      });
+   }
+   return result;
+}
+
+}  // namespace
+
+TEST(TupleCountMap, countsEqualTuples) {
+   std::vector<int32_t> values;
+   std::map<int32_t, uint32_t> expected;
+   for (int32_t i = 0; i < 10000; ++i) {
+      values.push_back(i % 1234);
+      ++expected[i % 1234];
+   }
+   auto columns = createIntColumn(values);
+   TupleFactory factory(columns.second, columns.second.metadata);
+   TupleCountMap under_test(factory);
+
+   countAllRows(factory, under_test, values.size());
+
+   ASSERT_EQ(under_test.size(), 1234);
+   ASSERT_EQ(toStdMap(under_test), expected);
+}
+
+TEST(TupleCountMap, mergesMapsOfDifferentPartitions) {
+   auto columns1 = createIntColumn({1, 2, 3, 2});
+   auto columns2 = createIntColumn({3, 4, 3});
+   TupleFactory factory1(columns1.second, columns1.second.metadata);
+   TupleFactory factory2(columns2.second, columns2.second.metadata);
+   std::vector<TupleCountMap> maps;
+   maps.emplace_back(factory1);
+   maps.emplace_back(factory2);
+   countAllRows(factory1, maps[0], 4);
+   countAllRows(factory2, maps[1], 3);
+
+   TupleCountMap under_test = TupleCountMap::merge(factory1, maps);
+
+   ASSERT_EQ(under_test.size(), 4);
+   const std::map<int32_t, uint32_t> expected{{1, 1}, {2, 2}, {3, 3}, {4, 1}};
+   ASSERT_EQ(toStdMap(under_test), expected);
+}
@@ -1,16 +1,36 @@
 #include "silo/query_engine/query_result.h"
 
+#include <iterator>
+#include <utility>
+
 #include <nlohmann/json.hpp>
 
 #include "silo_api/variant_json_serializer.h"
 
 namespace silo::query_engine {
 
+bool QueryResult::isStreamed() const {
+   return static_cast<bool>(next_chunk);
+}
+
+void QueryResult::materialize() {
+   if (!isStreamed()) {
+      return;
+   }
+   for (auto chunk = next_chunk(); !chunk.empty(); chunk = next_chunk()) {
+      std::move(chunk.begin(), chunk.end(), std::back_inserter(query_result));
+   }
+   next_chunk = nullptr;
+}
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 void to_json(nlohmann::json& json, const QueryResult& query_result) {
    json = nlohmann::json{
       {"queryResult", query_result.query_result},
    };
+   if (query_result.continuation_token.has_value()) {
+      json["continuationToken"] = query_result.continuation_token.value();
+   }
 }
 
 // NOLINTNEXTLINE(readability-identifier-naming)
@@ -42,6 +42,11 @@ const std::vector<silo::Idx>& IndexedStringColumnPartition::getValues() const {
    return this->value_ids;
 }
 
+const std::unordered_map<Idx, roaring::Roaring>& IndexedStringColumnPartition::getValueBitmaps(
+) const {
+   return this->indexed_values;
+}
+
 IndexedStringColumn::IndexedStringColumn() {
    lookup = std::make_unique<common::BidirectionalMap<std::string>>();
 }
@@ -79,6 +79,12 @@ std::optional<const roaring::Roaring*> PangoLineageColumnPartition::filterInclud
 const std::vector<silo::Idx>& PangoLineageColumnPartition::getValues() const {
    return this->value_ids;
 }
+
+const std::unordered_map<Idx, roaring::Roaring>& PangoLineageColumnPartition::getValueBitmaps(
+) const {
+   return this->indexed_values;
+}
+
 common::AliasedPangoLineage PangoLineageColumnPartition::lookupAliasedValue(Idx idx) const {
    return lookup_aliased.getValue(idx);
 }
@@ -0,0 +1,54 @@
+#include "silo/storage/row_sample.h"
+
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace silo::storage {
+
+namespace {
+
+constexpr uint32_t PARTITION_ID_SHIFT = 32;
+
+/// Finalizer of splitmix64, which spreads consecutive row ids uniformly over all 64 bit values
+uint64_t hashRow(uint64_t partition_id, uint32_t row) {
+   uint64_t hash = (partition_id << PARTITION_ID_SHIFT) | row;
+   hash = (hash ^ (hash >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+   hash = (hash ^ (hash >> 27U)) * 0x94d049bb133111ebULL;
+   return hash ^ (hash >> 31U);
+}
+
+}  // namespace
+
+RowSample::RowSample(uint32_t partition_id, uint32_t row_count) {
+   std::vector<std::vector<uint32_t>> rows_per_level;
+   for (uint32_t row = 0; row < row_count; ++row) {
+      const auto depth = static_cast<size_t>(std::countl_zero(hashRow(partition_id, row)));
+      if (rows_per_level.size() < depth) {
+         rows_per_level.resize(depth);
+      }
+      for (size_t level_index = 0; level_index < depth; ++level_index) {
+         rows_per_level[level_index].push_back(row);
+      }
+   }
+   levels.reserve(rows_per_level.size());
+   for (const auto& rows : rows_per_level) {
+      roaring::Roaring level(rows.size(), rows.data());
+      level.runOptimize();
+      levels.push_back(std::move(level));
+   }
+}
+
+const roaring::Roaring& RowSample::getLevel(uint32_t level) const {
+   assert(level > 0);
+   static const roaring::Roaring EMPTY_LEVEL;
+   if (level > levels.size()) {
+      return EMPTY_LEVEL;
+   }
+   return levels[level - 1];
+}
+
+}  // namespace silo::storage
@@ -1,8 +1,17 @@
 #include "silo/storage/unaligned_sequence_store.h"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <array>
+#include <cassert>
+#include <fstream>
+#include <stdexcept>
 #include <string>
 #include <utility>
+#include <variant>
 #include <vector>
 
 #include <oneapi/tbb/blocked_range.h>
@@ -18,17 +27,184 @@
 #include "silo/preprocessing/preprocessing_exception.h"
 #include "silo/zstdfasta/zstdfasta_table_reader.h"
 
+namespace {
+
+std::filesystem::path withSuffix(const std::filesystem::path& file_prefix, std::string_view suffix) {
+   return file_prefix.string() + std::string(suffix);
+}
+
+/// Writes the compressed sequences of the rows one after another to the sequences file and their
+/// offsets to the offsets file, without holding more than one sequence in memory
+class RowIndexWriter {
+   std::filesystem::path sequences_file;
+   std::ofstream sequences_output;
+   std::ofstream offsets_output;
+   uint64_t offset = 0;
+
+   void writeOffset() {
+      offsets_output.write(reinterpret_cast<const char*>(&offset), sizeof(uint64_t));
+   }
+
+  public:
+   RowIndexWriter(const std::filesystem::path& offsets_file, std::filesystem::path sequences_file)
+       : sequences_file(std::move(sequences_file)),
+         sequences_output(this->sequences_file, std::ios::binary | std::ios::trunc),
+         offsets_output(offsets_file, std::ios::binary | std::ios::trunc) {}
+
+   void append(const std::optional<std::string>& compressed_sequence) {
+      writeOffset();
+      if (compressed_sequence.has_value()) {
+         sequences_output.write(
+            compressed_sequence->data(), static_cast<std::streamsize>(compressed_sequence->size())
+         );
+         offset += compressed_sequence->size();
+      }
+   }
+
+   /// Writes the end of the last sequence and closes the files
+   void finish() {
+      writeOffset();
+      sequences_output.close();
+      offsets_output.close();
+      if (!sequences_output || !offsets_output) {
+         throw silo::preprocessing::PreprocessingException(
+            "Cannot write the unaligned sequences to " + sequences_file.string()
+         );
+      }
+   }
+};
+
+}  // namespace
+
+std::string silo::primaryKeyToString(const common::JsonValueType::value_type& primary_key) {
+   if (std::holds_alternative<double>(primary_key)) {
+      return std::to_string(std::get<double>(primary_key));
+   }
+   if (std::holds_alternative<int32_t>(primary_key)) {
+      return std::to_string(std::get<int32_t>(primary_key));
+   }
+   assert(std::holds_alternative<std::string>(primary_key));
+   return std::get<std::string>(primary_key);
+}
+
+/// A read-only memory mapping of a whole file
+class silo::UnalignedSequenceStorePartition::MappedFile {
+   const char* data = nullptr;
+   size_t size = 0;
+
+  public:
+   explicit MappedFile(const std::filesystem::path& path) {
+      const int file_descriptor = ::open(path.c_str(), O_RDONLY);
+      if (file_descriptor < 0) {
+         throw persistence::LoadDatabaseException("Cannot open file " + path.string());
+      }
+      struct stat file_stat {};
+      if (::fstat(file_descriptor, &file_stat) != 0) {
+         ::close(file_descriptor);
+         throw persistence::LoadDatabaseException("Cannot read the size of file " + path.string());
+      }
+      size = static_cast<size_t>(file_stat.st_size);
+      if (size > 0) {
+         void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, file_descriptor, 0);
+         if (mapping == MAP_FAILED) {
+            ::close(file_descriptor);
+            throw persistence::LoadDatabaseException("Cannot map file " + path.string());
+         }
+         data = static_cast<const char*>(mapping);
+      }
+      ::close(file_descriptor);
+   }
+
+   MappedFile(const MappedFile& other) = delete;
+   MappedFile& operator=(const MappedFile& other) = delete;
+
+   ~MappedFile() {
+      if (data != nullptr) {
+         ::munmap(const_cast<char*>(data), size);
+      }
+   }
+
+   [[nodiscard]] std::string_view view(uint64_t begin, uint64_t end) const {
+      if (begin > end || end > size) {
+         throw std::out_of_range("Range is outside of the mapped file");
+      }
+      return {data + begin, end - begin};
+   }
+};
+
 silo::UnalignedSequenceStorePartition::UnalignedSequenceStorePartition(
    std::string sql_for_reading_file,
+   std::filesystem::path file_prefix,
    const std::string& compression_dictionary
 )
     : sql_for_reading_file(std::move(sql_for_reading_file)),
-      compression_dictionary(compression_dictionary) {}
+      offsets_file(withSuffix(file_prefix, ".offsets")),
+      sequences_file(withSuffix(file_prefix, ".sequences")),
+      compression_dictionary(compression_dictionary) {
+   if (std::filesystem::is_regular_file(offsets_file) &&
+       std::filesystem::is_regular_file(sequences_file)) {
+      loadRowIndex();
+   }
+}
 
 std::string silo::UnalignedSequenceStorePartition::getReadSQL() const {
    return sql_for_reading_file;
 }
 
+void silo::UnalignedSequenceStorePartition::loadRowIndex() {
+   std::ifstream offsets_input(offsets_file, std::ios::binary | std::ios::ate);
+   if (!offsets_input) {
+      throw persistence::LoadDatabaseException("Cannot open file " + offsets_file.string());
+   }
+   const auto file_size = static_cast<size_t>(offsets_input.tellg());
+   offsets.resize(file_size / sizeof(uint64_t));
+   offsets_input.seekg(0);
+   offsets_input.read(
+      reinterpret_cast<char*>(offsets.data()), static_cast<std::streamsize>(file_size)
+   );
+   mapped_sequences = std::make_shared<const MappedFile>(sequences_file);
+}
+
+void silo::UnalignedSequenceStorePartition::fill(
+   const std::vector<std::optional<std::string>>& compressed_sequences
+) {
+   RowIndexWriter writer(offsets_file, sequences_file);
+   for (const auto& compressed_sequence : compressed_sequences) {
+      writer.append(compressed_sequence);
+   }
+   writer.finish();
+   loadRowIndex();
+}
+
+size_t silo::UnalignedSequenceStorePartition::fill(ZstdFastaTableReader& input) {
+   input.loadTable();
+   RowIndexWriter writer(offsets_file, sequences_file);
+   size_t read_sequences_count = 0;
+   std::optional<std::string> compressed_sequence;
+   while (input.nextCompressed(compressed_sequence)) {
+      writer.append(compressed_sequence);
+      ++read_sequences_count;
+   }
+   writer.finish();
+   loadRowIndex();
+   return read_sequences_count;
+}
+
+bool silo::UnalignedSequenceStorePartition::hasRowIndex() const {
+   return mapped_sequences != nullptr;
+}
+
+std::optional<std::string_view> silo::UnalignedSequenceStorePartition::getCompressedSequence(
+   uint32_t row_id
+) const {
+   const uint64_t begin = offsets.at(row_id);
+   const uint64_t end = offsets.at(row_id + 1);
+   if (begin == end) {
+      return std::nullopt;
+   }
+   return mapped_sequences->view(begin, end);
+}
+
 silo::UnalignedSequenceStore::UnalignedSequenceStore(
    std::filesystem::path folder_path,
    std::string&& compression_dictionary
@@ -45,10 +221,15 @@ silo::UnalignedSequenceStorePartition& silo::UnalignedSequenceStore::createParti
          folder_path.string(),
          partition_id
       ),
+      partitionFilename(partition_id),
       compression_dictionary
    );
 }
 
+std::filesystem::path silo::UnalignedSequenceStore::partitionFilename(size_t partition_id) const {
+   return folder_path / fmt::format("P{}", partition_id);
+}
+
 void silo::UnalignedSequenceStore::saveFolder(const std::filesystem::path& save_location) const {
    std::filesystem::copy(folder_path, save_location, std::filesystem::copy_options::recursive);
 }
@@ -0,0 +1,37 @@
+#include "silo/storage/unaligned_sequence_store.h"
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(UnalignedSequenceStore, readsFilledSequencesByRowId) {
+   const std::filesystem::path directory = "output/unaligned_sequence_store_test";
+   std::filesystem::remove_all(directory);
+   std::filesystem::create_directories(directory);
+
+   silo::UnalignedSequenceStore store(directory, "ACGT");
+   auto& partition = store.createPartition();
+   EXPECT_FALSE(partition.hasRowIndex());
+
+   const std::vector<std::optional<std::string>> compressed_sequences{
+      "first", std::nullopt, "", "third"
+   };
+   partition.fill(compressed_sequences);
+
+   ASSERT_TRUE(partition.hasRowIndex());
+   EXPECT_EQ(partition.getCompressedSequence(0), "first");
+   EXPECT_EQ(partition.getCompressedSequence(1), std::nullopt);
+   EXPECT_EQ(partition.getCompressedSequence(2), std::nullopt);
+   EXPECT_EQ(partition.getCompressedSequence(3), "third");
+   EXPECT_THROW((void)partition.getCompressedSequence(4), std::out_of_range);
+
+   silo::UnalignedSequenceStore reloaded_store(directory, "ACGT");
+   const auto& reloaded_partition = reloaded_store.createPartition();
+   ASSERT_TRUE(reloaded_partition.hasRowIndex());
+   EXPECT_EQ(reloaded_partition.getCompressedSequence(3), "third");
+
+   std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,225 @@
+#include <nlohmann/json.hpp>
+
+#include <optional>
+
+#include "silo/test/query_fixture.test.h"
+
+using nlohmann::json;
+
+using silo::ReferenceGenomes;
+using silo::config::DatabaseConfig;
+using silo::config::ValueType;
+using silo::test::QueryTestData;
+using silo::test::QueryTestScenario;
+
+const auto DATA_JSON = R"([
+   {
+      "metadata": {"key": "id1", "country": "Switzerland", "pango_lineage": "B.1", "age": 30},
+      "alignedNucleotideSequences": {"segment1": null},
+      "unalignedNucleotideSequences": {"segment1": null},
+      "alignedAminoAcidSequences": {"gene1": null}
+   },
+   {
+      "metadata": {"key": "id2", "country": "Germany", "pango_lineage": "B.1", "age": 40},
+      "alignedNucleotideSequences": {"segment1": null},
+      "unalignedNucleotideSequences": {"segment1": null},
+      "alignedAminoAcidSequences": {"gene1": null}
+   },
+   {
+      "metadata": {"key": "id3", "country": "Switzerland", "pango_lineage": "A", "age": 50},
+      "alignedNucleotideSequences": {"segment1": null},
+      "unalignedNucleotideSequences": {"segment1": null},
+      "alignedAminoAcidSequences": {"gene1": null}
+   },
+   {
+      "metadata": {"key": "id4", "country": null, "pango_lineage": "B.1", "age": 60},
+      "alignedNucleotideSequences": {"segment1": null},
+      "unalignedNucleotideSequences": {"segment1": null},
+      "alignedAminoAcidSequences": {"gene1": null}
+   },
+   {
+      "metadata": {"key": "id5", "country": "Switzerland", "pango_lineage": "B.1", "age": 70},
+      "alignedNucleotideSequences": {"segment1": null},
+      "unalignedNucleotideSequences": {"segment1": null},
+      "alignedAminoAcidSequences": {"gene1": null}
+   }
+])";
+
+const std::vector<json> DATA = json::parse(DATA_JSON);
+
+const auto DATABASE_CONFIG = DatabaseConfig{
+   .default_nucleotide_sequence = "segment1",
+   .schema =
+      {.instance_name = "dummy name",
+       .metadata =
+          {{.name = "key", .type = ValueType::STRING},
+           {.name = "country", .type = ValueType::STRING, .generate_index = true},
+           {.name = "pango_lineage", .type = ValueType::PANGOLINEAGE, .generate_index = true},
+           {.name = "age", .type = ValueType::INT}},
+       .primary_key = "key",
+       .partition_by = "pango_lineage"}
+};
+
+const auto REFERENCE_GENOMES = ReferenceGenomes{
+   {{"segment1", "A"}},
+   {{"gene1", "*"}},
+};
+
+const QueryTestData TEST_DATA{
+   .ndjson_input_data = DATA,
+   .database_config = DATABASE_CONFIG,
+   .reference_genomes = REFERENCE_GENOMES
+};
+
+const QueryTestScenario GROUP_BY_INDEXED_STRING = {
+   .name = "groupByIndexedStringColumn",
+   .query = json::parse(
+      R"({"action": {"type": "Aggregated", "groupByFields": ["country"], "orderByFields": ["country"]},
+         "filterExpression": {"type": "True"}})"
+   ),
+   .expected_query_result = json::parse(
+      R"([{"count": 1, "country": null},
+          {"count": 1, "country": "Germany"},
+          {"count": 3, "country": "Switzerland"}])"
+   )
+};
+
+const QueryTestScenario GROUP_BY_PANGO_LINEAGE = {
+   .name = "groupByPangoLineageColumn",
+   .query = json::parse(
+      R"({"action": {"type": "Aggregated", "groupByFields": ["pango_lineage"], "orderByFields": ["pango_lineage"]},
+         "filterExpression": {"type": "IntBetween", "column": "age", "from": 40, "to": null}})"
+   ),
+   .expected_query_result = json::parse(
+      R"([{"count": 1, "pango_lineage": "A"},
+          {"count": 3, "pango_lineage": "B.1"}])"
+   )
+};
+
+const QueryTestScenario GROUP_BY_TWO_INDEXED_COLUMNS = {
+   .name = "groupByTwoIndexedColumns",
+   .query = json::parse(
+      R"({"action": {"type": "Aggregated", "groupByFields": ["country", "pango_lineage"],
+                     "orderByFields": ["country", "pango_lineage"]},
+         "filterExpression": {"type": "True"}})"
+   ),
+   .expected_query_result = json::parse(
+      R"([{"count": 1, "country": null, "pango_lineage": "B.1"},
+          {"count": 1, "country": "Germany", "pango_lineage": "B.1"},
+          {"count": 1, "country": "Switzerland", "pango_lineage": "A"},
+          {"count": 2, "country": "Switzerland", "pango_lineage": "B.1"}])"
+   )
+};
+
+const QueryTestScenario GROUP_BY_INDEXED_COLUMNS_SPARSE_FILTER = {
+   .name = "groupByIndexedColumnsWithFewerRowsThanValues",
+   .query = json::parse(
+      R"({"action": {"type": "Aggregated", "groupByFields": ["pango_lineage", "country"]},
+         "filterExpression": {"type": "IntEquals", "column": "age", "value": 40}})"
+   ),
+   .expected_query_result = json::parse(
+      R"([{"count": 1, "country": "Germany", "pango_lineage": "B.1"}])"
+   )
+};
+
+const QueryTestScenario GROUP_BY_PARTITION_BY_AND_OTHER_COLUMNS = {
+   .name = "groupByPartitionByColumnAndOtherColumns",
+   .query = json::parse(
+      R"({"action": {"type": "Aggregated", "groupByFields": ["country", "pango_lineage", "age"],
+                     "orderByFields": ["pango_lineage", "age"]},
+         "filterExpression": {"type": "IntBetween", "column": "age", "from": null, "to": 60}})"
+   ),
+   .expected_query_result = json::parse(
+      R"([{"age": 50, "count": 1, "country": "Switzerland", "pango_lineage": "A"},
+          {"age": 30, "count": 1, "country": "Switzerland", "pango_lineage": "B.1"},
+          {"age": 40, "count": 1, "country": "Germany", "pango_lineage": "B.1"},
+          {"age": 60, "count": 1, "country": null, "pango_lineage": "B.1"}])"
+   )
+};
+
+const QueryTestScenario AGGREGATE_FUNCTIONS = {
+   .name = "aggregateFunctionsPerGroup",
+   .query = json::parse(
+      R"({"action": {"type": "Aggregated", "groupByFields": ["pango_lineage"],
+                     "aggregates": [{"function": "sum", "field": "age"},
+                                    {"function": "mean", "field": "age"},
+                                    {"function": "min", "field": "age"},
+                                    {"function": "max", "field": "age"},
+                                    {"function": "countDistinct", "field": "age"}],
+                     "orderByFields": [{"field": "max_age", "order": "descending"}]},
+         "filterExpression": {"type": "True"}})"
+   ),
+   .expected_query_result = json::parse(
+      R"([{"count": 4, "pango_lineage": "B.1", "sum_age": 200, "mean_age": 50.0, "min_age": 30,
+           "max_age": 70, "countDistinct_age": 4},
+          {"count": 1, "pango_lineage": "A", "sum_age": 50, "mean_age": 50.0, "min_age": 50,
+           "max_age": 50, "countDistinct_age": 1}])"
+   )
+};
+
+const QueryTestScenario AGGREGATE_FUNCTIONS_WITHOUT_GROUPING = {
+   .name = "aggregateFunctionsWithoutGroupingOnEmptyFilter",
+   .query = json::parse(
+      R"({"action": {"type": "Aggregated",
+                     "aggregates": [{"function": "sum", "field": "age"},
+                                    {"function": "countDistinct", "field": "age"}]},
+         "filterExpression": {"type": "False"}})"
+   ),
+   .expected_query_result =
+      json::parse(R"([{"count": 0, "sum_age": null, "countDistinct_age": 0}])")
+};
+
+const QueryTestScenario TOP_GROUPS_BY_COUNT = {
+   .name = "topGroupsByCount",
+   .query = json::parse(
+      R"({"action": {"type": "Aggregated", "groupByFields": ["country"],
+                     "orderByFields": [{"field": "count", "order": "descending"}], "limit": 1},
+         "filterExpression": {"type": "True"}})"
+   ),
+   .expected_query_result = json::parse(R"([{"count": 3, "country": "Switzerland"}])")
+};
+
+const QueryTestScenario TOP_GROUPS_BY_AGGREGATE_WITH_OFFSET = {
+   .name = "topGroupsByAggregateWithOffset",
+   .query = json::parse(
+      R"({"action": {"type": "Aggregated", "groupByFields": ["country"],
+                     "aggregates": [{"function": "min", "field": "age"}],
+                     "orderByFields": [{"field": "min_age", "order": "descending"}],
+                     "limit": 1, "offset": 1},
+         "filterExpression": {"type": "True"}})"
+   ),
+   .expected_query_result =
+      json::parse(R"([{"count": 1, "country": "Germany", "min_age": 40}])")
+};
+
+const QueryTestScenario ORDER_BY_NULLABLE_FIELD_DESCENDING = {
+   .name = "orderByNullableFieldDescending",
+   .query = json::parse(
+      R"({"action": {"type": "Aggregated", "groupByFields": ["country"],
+                     "aggregates": [{"function": "mean", "field": "age"}],
+                     "orderByFields": [{"field": "country", "order": "descending"}]},
+         "filterExpression": {"type": "True"}})"
+   ),
+   .expected_query_result = json::parse(
+      R"([{"count": 3, "country": "Switzerland", "mean_age": 50.0},
+          {"count": 1, "country": "Germany", "mean_age": 40.0},
+          {"count": 1, "country": null, "mean_age": 60.0}])"
+   )
+};
+
+QUERY_TEST(
+   AggregatedTest,
+   TEST_DATA,
+   ::testing::Values(
+      GROUP_BY_INDEXED_STRING,
+      GROUP_BY_PANGO_LINEAGE,
+      GROUP_BY_TWO_INDEXED_COLUMNS,
+      GROUP_BY_INDEXED_COLUMNS_SPARSE_FILTER,
+      GROUP_BY_PARTITION_BY_AND_OTHER_COLUMNS,
+      AGGREGATE_FUNCTIONS,
+      AGGREGATE_FUNCTIONS_WITHOUT_GROUPING,
+      TOP_GROUPS_BY_COUNT,
+      TOP_GROUPS_BY_AGGREGATE_WITH_OFFSET,
+      ORDER_BY_NULLABLE_FIELD_DESCENDING
+   )
+);
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include "silo/query_engine/actions/details.h"
+#include "silo/query_engine/query_parse_exception.h"
+#include "silo/test/query_fixture.test.h"
+
+using nlohmann::json;
+
+using silo::ReferenceGenomes;
+using silo::config::DatabaseConfig;
+using silo::config::ValueType;
+using silo::test::QueryTestData;
+using silo::test::QueryTestScenario;
+
+nlohmann::json createDataWithCountryAndAge(
+   const std::string& key,
+   const std::string& country,
+   int age
+) {
+   return {
+      {"metadata", {{"key", key}, {"country", country}, {"age", age}}},
+      {"alignedNucleotideSequences", {{"segment1", nullptr}}},
+      {"unalignedNucleotideSequences", {{"segment1", nullptr}}},
+      {"alignedAminoAcidSequences", {{"gene1", nullptr}}}
+   };
+}
+
+const std::vector<nlohmann::json> DATA = {
+   createDataWithCountryAndAge("id1", "Switzerland", 30),
+   createDataWithCountryAndAge("id2", "Germany", 50),
+   createDataWithCountryAndAge("id3", "Switzerland", 40),
+   createDataWithCountryAndAge("id4", "France", 60),
+   createDataWithCountryAndAge("id5", "Germany", 20)
+};
+
+const auto DATABASE_CONFIG = DatabaseConfig{
+   .default_nucleotide_sequence = "segment1",
+   .schema =
+      {.instance_name = "dummy name",
+       .metadata =
+          {{.name = "key", .type = ValueType::STRING},
+           {.name = "country", .type = ValueType::STRING},
+           {.name = "age", .type = ValueType::INT}},
+       .primary_key = "key"}
+};
+
+const auto REFERENCE_GENOMES = ReferenceGenomes{
+   {{"segment1", "A"}},
+   {{"gene1", "*"}},
+};
+
+const QueryTestData TEST_DATA{
+   .ndjson_input_data = DATA,
+   .database_config = DATABASE_CONFIG,
+   .reference_genomes = REFERENCE_GENOMES
+};
+
+const QueryTestScenario ORDER_BY_WITH_OFFSET_AND_LIMIT = {
+   .name = "orderByWithOffsetAndLimit",
+   .query = json::parse(
+      R"({"action": {"type": "Details", "fields": ["key", "country", "age"],
+                     "orderByFields": [{"field": "age", "order": "descending"}],
+                     "offset": 1, "limit": 2},
+         "filterExpression": {"type": "True"}})"
+   ),
+   .expected_query_result = json::parse(
+      R"([{"key": "id2", "country": "Germany", "age": 50},
+          {"key": "id3", "country": "Switzerland", "age": 40}])"
+   )
+};
+
+const QueryTestScenario ORDER_BY_WITHOUT_LIMIT = {
+   .name = "orderByWithoutLimit",
+   .query = json::parse(
+      R"({"action": {"type": "Details", "fields": ["country", "key"],
+                     "orderByFields": ["country", "key"], "offset": 2},
+         "filterExpression": {"type": "True"}})"
+   ),
+   .expected_query_result = json::parse(
+      R"([{"key": "id5", "country": "Germany"},
+          {"key": "id1", "country": "Switzerland"},
+          {"key": "id3", "country": "Switzerland"}])"
+   )
+};
+
+const QueryTestScenario ORDER_BY_INT_WITHOUT_LIMIT = {
+   .name = "orderByIntWithoutLimit",
+   .query = json::parse(
+      R"({"action": {"type": "Details", "fields": ["key", "age"],
+                     "orderByFields": [{"field": "age", "order": "ascending"}], "offset": 3},
+         "filterExpression": {"type": "True"}})"
+   ),
+   .expected_query_result = json::parse(R"([{"key": "id2", "age": 50}, {"key": "id4", "age": 60}])")
+};
+
+const QueryTestScenario LIMIT_ZERO = {
+   .name = "limitZero",
+   .query = json::parse(
+      R"({"action": {"type": "Details", "orderByFields": ["age"], "limit": 0},
+         "filterExpression": {"type": "True"}})"
+   ),
+   .expected_query_result = json::parse(R"([])")
+};
+
+const QueryTestScenario SAMPLE_LARGER_THAN_FILTER = {
+   .name = "sampleLargerThanFilter",
+   .query = json::parse(
+      R"({"action": {"type": "Details", "fields": ["key", "age"],
+                     "sample": {"size": 10, "seed": 1234},
+                     "orderByFields": [{"field": "age", "order": "descending"}]},
+         "filterExpression": {"type": "StringEquals", "column": "country", "value": "Switzerland"}})"
+   ),
+   .expected_query_result = json::parse(R"([{"key": "id3", "age": 40}, {"key": "id1", "age": 30}])")
+};
+
+QUERY_TEST(
+   DetailsTest,
+   TEST_DATA,
+   ::testing::Values(
+      ORDER_BY_WITH_OFFSET_AND_LIMIT,
+      ORDER_BY_WITHOUT_LIMIT,
+      ORDER_BY_INT_WITHOUT_LIMIT,
+      LIMIT_ZERO,
+      SAMPLE_LARGER_THAN_FILTER
+   )
+);
+
+TEST(DetailsCursor, roundTripsThroughContinuationToken) {
+   const silo::query_engine::actions::DetailsCursor cursor{
+      .data_version = "1234", .partition_id = 2, .row = 17, .primary_key = R"({"key":"id3"})"
+   };
+   const auto decoded = silo::query_engine::actions::DetailsCursor::fromContinuationToken(
+      cursor.toContinuationToken()
+   );
+   EXPECT_EQ(decoded.data_version, "1234");
+   EXPECT_EQ(decoded.partition_id, 2);
+   EXPECT_EQ(decoded.row, 17);
+   EXPECT_EQ(decoded.primary_key, R"({"key":"id3"})");
+}
+
+TEST(DetailsCursor, rejectsInvalidContinuationToken) {
+   EXPECT_THROW(
+      silo::query_engine::actions::DetailsCursor::fromContinuationToken("not a token"),
+      silo::QueryParseException
+   );
+}
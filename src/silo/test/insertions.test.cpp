@@ -0,0 +1,147 @@
+#include <nlohmann/json.hpp>
+
+#include "silo/test/query_fixture.test.h"
+
+using nlohmann::json;
+
+using silo::ReferenceGenomes;
+using silo::config::DatabaseConfig;
+using silo::config::ValueType;
+using silo::test::QueryTestData;
+using silo::test::QueryTestScenario;
+
+// The rows of each partition are sorted by key:
+// partition B.1 contains id1, id2, id4, id5 and partition A contains id3, id6
+const auto DATA_JSON = R"([
+   {
+      "metadata": {"key": "id1", "pango_lineage": "B.1", "age": 30},
+      "alignedNucleotideSequences": {"segment1": null},
+      "unalignedNucleotideSequences": {"segment1": null},
+      "alignedAminoAcidSequences": {"gene1": null},
+      "nucleotideInsertions": {"segment1": ["3:ACT"]}
+   },
+   {
+      "metadata": {"key": "id2", "pango_lineage": "B.1", "age": 40},
+      "alignedNucleotideSequences": {"segment1": null},
+      "unalignedNucleotideSequences": {"segment1": null},
+      "alignedAminoAcidSequences": {"gene1": null},
+      "nucleotideInsertions": {"segment1": ["3:ACT"]}
+   },
+   {
+      "metadata": {"key": "id3", "pango_lineage": "A", "age": 50},
+      "alignedNucleotideSequences": {"segment1": null},
+      "unalignedNucleotideSequences": {"segment1": null},
+      "alignedAminoAcidSequences": {"gene1": null},
+      "nucleotideInsertions": {"segment1": ["3:ACT"]}
+   },
+   {
+      "metadata": {"key": "id4", "pango_lineage": "B.1", "age": 60},
+      "alignedNucleotideSequences": {"segment1": null},
+      "unalignedNucleotideSequences": {"segment1": null},
+      "alignedAminoAcidSequences": {"gene1": null},
+      "nucleotideInsertions": {"segment1": ["3:GG"]}
+   },
+   {
+      "metadata": {"key": "id5", "pango_lineage": "B.1", "age": 70},
+      "alignedNucleotideSequences": {"segment1": null},
+      "unalignedNucleotideSequences": {"segment1": null},
+      "alignedAminoAcidSequences": {"gene1": null},
+      "nucleotideInsertions": {"segment1": ["3:CCC", "5:TT"]}
+   },
+   {
+      "metadata": {"key": "id6", "pango_lineage": "A", "age": 20},
+      "alignedNucleotideSequences": {"segment1": null},
+      "unalignedNucleotideSequences": {"segment1": null},
+      "alignedAminoAcidSequences": {"gene1": null},
+      "nucleotideInsertions": {"segment1": ["3:GG"]}
+   }
+])";
+
+const std::vector<json> DATA = json::parse(DATA_JSON);
+
+const auto DATABASE_CONFIG = DatabaseConfig{
+   .default_nucleotide_sequence = "segment1",
+   .schema =
+      {.instance_name = "dummy name",
+       .metadata =
+          {{.name = "key", .type = ValueType::STRING},
+           {.name = "pango_lineage", .type = ValueType::PANGOLINEAGE, .generate_index = true},
+           {.name = "age", .type = ValueType::INT},
+           {.name = "nucleotideInsertions", .type = ValueType::NUC_INSERTION}},
+       .primary_key = "key",
+       .partition_by = "pango_lineage"}
+};
+
+const auto REFERENCE_GENOMES = ReferenceGenomes{
+   {{"segment1", "ACGTACGT"}},
+   {{"gene1", "M*"}},
+};
+
+const QueryTestData TEST_DATA{
+   .ndjson_input_data = DATA,
+   .database_config = DATABASE_CONFIG,
+   .reference_genomes = REFERENCE_GENOMES
+};
+
+const QueryTestScenario ALL_ROWS_OF_ALL_PARTITIONS = {
+   .name = "sumsCountsOfAllPartitions",
+   .query = json::parse(
+      R"({"action": {"type": "Insertions", "orderByFields": ["position", "insertedSymbols"]},
+         "filterExpression": {"type": "True"}})"
+   ),
+   .expected_query_result = json::parse(R"([
+      {"count": 3, "insertedSymbols": "ACT", "insertion": "ins_3:ACT", "position": 3,
+       "sequenceName": "segment1"},
+      {"count": 1, "insertedSymbols": "CCC", "insertion": "ins_3:CCC", "position": 3,
+       "sequenceName": "segment1"},
+      {"count": 2, "insertedSymbols": "GG", "insertion": "ins_3:GG", "position": 3,
+       "sequenceName": "segment1"},
+      {"count": 1, "insertedSymbols": "TT", "insertion": "ins_5:TT", "position": 5,
+       "sequenceName": "segment1"}
+   ])")
+};
+
+const QueryTestScenario FILTER_SPANNING_PARTITIONS = {
+   .name = "sumsCountsOfFilteredRowsOfSeveralPartitions",
+   .query = json::parse(
+      R"({"action": {"type": "Insertions", "orderByFields": ["position", "insertedSymbols"]},
+         "filterExpression": {"type": "Or", "children": [
+            {"type": "IntBetween", "column": "age", "from": 40, "to": 50},
+            {"type": "IntEquals", "column": "age", "value": 70}
+         ]}})"
+   ),
+   .expected_query_result = json::parse(R"([
+      {"count": 2, "insertedSymbols": "ACT", "insertion": "ins_3:ACT", "position": 3,
+       "sequenceName": "segment1"},
+      {"count": 1, "insertedSymbols": "CCC", "insertion": "ins_3:CCC", "position": 3,
+       "sequenceName": "segment1"},
+      {"count": 1, "insertedSymbols": "TT", "insertion": "ins_5:TT", "position": 5,
+       "sequenceName": "segment1"}
+   ])")
+};
+
+// Selects id1, id2 of partition B.1 and id6 of partition A. The insertions of id3, id4 and id5
+// lie entirely before or after the filtered rows of their partition
+const QueryTestScenario FILTER_OUTSIDE_OF_INSERTION_ROWS = {
+   .name = "skipsInsertionsOutsideOfFilteredRows",
+   .query = json::parse(
+      R"({"action": {"type": "Insertions", "orderByFields": ["position", "insertedSymbols"]},
+         "filterExpression": {"type": "IntBetween", "column": "age", "from": null, "to": 40}})"
+   ),
+   .expected_query_result = json::parse(R"([
+      {"count": 2, "insertedSymbols": "ACT", "insertion": "ins_3:ACT", "position": 3,
+       "sequenceName": "segment1"},
+      {"count": 1, "insertedSymbols": "GG", "insertion": "ins_3:GG", "position": 3,
+       "sequenceName": "segment1"}
+   ])")
+};
+
+QUERY_TEST(
+   InsertionsTest,
+   TEST_DATA,
+   ::testing::Values(
+      ALL_ROWS_OF_ALL_PARTITIONS,
+      FILTER_SPANNING_PARTITIONS,
+      FILTER_OUTSIDE_OF_INSERTION_ROWS
+   )
+);
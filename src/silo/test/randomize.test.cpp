@@ -138,23 +138,15 @@ const QueryTestScenario AGGREGATE = {
       R"({"action": {"type": "Aggregated", "groupByFields": ["key"], "randomize": {"seed": 12321}},
          "filterExpression": {"type": "True"}})"
    ),
-#ifdef TARGET_CPU_ARM
    .expected_query_result = json::parse(
       R"([{"count": 1, "key": "id1"},
-          {"count": 1, "key": "id4"},
           {"count": 1, "key": "id2"},
           {"count": 1, "key": "id3"},
-          {"count": 1, "key": "id5"}])"
-   )
-#else
-   .expected_query_result = json::parse(
-      R"([{"count": 1, "key": "id3"},
-          {"count": 1, "key": "id1"},
           {"count": 1, "key": "id4"},
-          {"count": 1, "key": "id5"},
-          {"count": 1, "key": "id2"}])"
-   )
-#endif
+          {"count": 1, "key": "id5"}])"
+   ),
+   // The shuffled order depends on the iteration order of the group map
+   .ignore_order = true
 };
 
 const QueryTestScenario ORDER_BY_PRECEDENCE = {
@@ -215,18 +207,15 @@ const QueryTestScenario AGGREGATE_LIMIT_RANDOMIZE = {
    .name = "aggregateWithLimitAndOffsetRandomized",
    .query = json::parse(
       R"({"action": {"type": "Aggregated", "groupByFields": ["key", "col"], "randomize": {"seed": 123},
-                     "orderByFields": ["col"], "limit": 2, "offset": 1},
+                     "orderByFields": ["col"], "limit": 2, "offset": 3},
          "filterExpression": {"type": "True"}})"
    ),
    .expected_query_result = json::parse(
-#ifdef TARGET_CPU_ARM
-      R"([{"count": 1, "key": "id5", "col": "A"},
-          {"count": 1, "key": "id3", "col": "A"}])"
-#else
-      R"([{"count": 1, "key": "id1", "col": "A"},
-          {"count": 1, "key": "id3", "col": "A"}])"
-#endif
-   )
+      R"([{"count": 1, "key": "id2", "col": "B"},
+          {"count": 1, "key": "id4", "col": "B"}])"
+   ),
+   // Within a value of col, the order depends on the iteration order of the group map
+   .ignore_order = true
 };
 
 QUERY_TEST(
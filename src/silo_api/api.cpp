@@ -146,6 +146,14 @@ class SiloServer : public Poco::Util::ServerApplication {
                            .argument("NUMBER")
                            .binding("threadsForHttpConnections"));
 
+      options.addOption(Poco::Util::Option()
+                           .fullName(silo_api::MAX_STREAMED_SEQUENCES_OPTION)
+                           .description("maximum number of sequences returned by one query")
+                           .required(false)
+                           .repeatable(false)
+                           .argument("NUMBER")
+                           .binding(silo_api::MAX_STREAMED_SEQUENCES_OPTION));
+
       options.addOption(Poco::Util::Option()
                            .fullName(API_OPTION)
                            .shortName("a")
@@ -1,23 +1,68 @@
 #include "silo_api/query_handler.h"
 
 #include <cxxabi.h>
+#include <exception>
+#include <ostream>
 #include <string>
 
+#include <fmt/format.h>
+#include <Poco/Exception.h>
 #include <Poco/Net/HTTPResponse.h>
 #include <Poco/Net/HTTPServerRequest.h>
+#include <Poco/Net/HTTPServerRequestImpl.h>
 #include <Poco/Net/HTTPServerResponse.h>
 #include <Poco/StreamCopier.h>
 #include <spdlog/spdlog.h>
 #include <nlohmann/json.hpp>
 
 #include "silo/query_engine/query_parse_exception.h"
+#include "silo/query_engine/query_result.h"
 #include "silo_api/database_mutex.h"
 #include "silo_api/error_request_handler.h"
 
 namespace silo_api {
 
-QueryHandler::QueryHandler(silo_api::DatabaseMutex& database_mutex)
-    : database_mutex(database_mutex) {}
+namespace {
+
+void writeQueryResult(silo::query_engine::QueryResult& query_result, std::ostream& out_stream) {
+   for (const auto& entry : query_result.query_result) {
+      out_stream << nlohmann::json(entry) << '\n';
+   }
+   if (query_result.isStreamed()) {
+      // The next chunk is only produced once the previous one was written to the client
+      for (auto chunk = query_result.next_chunk(); !chunk.empty();
+           chunk = query_result.next_chunk()) {
+         for (const auto& entry : chunk) {
+            out_stream << nlohmann::json(entry) << '\n';
+         }
+         out_stream.flush();
+      }
+   }
+}
+
+/// A second response cannot be sent after the first one was committed. Instead, the connection
+/// is shut down before the final chunk, so that the client does not take the partial result for
+/// a complete one.
+void abortResponse(Poco::Net::HTTPServerRequest& request, Poco::Net::HTTPServerResponse& response) {
+   response.setKeepAlive(false);
+   auto* server_request = dynamic_cast<Poco::Net::HTTPServerRequestImpl*>(&request);
+   if (server_request != nullptr) {
+      try {
+         server_request->socket().shutdownSend();
+      } catch (const Poco::Exception& exception) {
+         SPDLOG_ERROR("Could not shut down the connection: {}", exception.displayText());
+      }
+   }
+}
+
+}  // namespace
+
+QueryHandler::QueryHandler(
+   silo_api::DatabaseMutex& database_mutex,
+   uint32_t max_streamed_sequences
+)
+    : database_mutex(database_mutex),
+      max_streamed_sequences(max_streamed_sequences) {}
 
 void QueryHandler::post(
    Poco::Net::HTTPServerRequest& request,
@@ -32,16 +77,46 @@ void QueryHandler::post(
    SPDLOG_INFO("Request Id [{}] - received query: {}", request_id, query);
 
    try {
+      // The database stays locked until the result is written. For streamed results, that
+      // depends on the client, which is why their size is bounded by max_streamed_sequences.
       const auto fixed_database = database_mutex.getDatabase();
 
-      const auto query_result = fixed_database.database.executeQuery(query);
+      auto query_result = fixed_database.database.executeQuery(query);
+      CHECK_SILO_QUERY(
+         !query_result.isStreamed() || query_result.streamed_entry_count <= max_streamed_sequences,
+         fmt::format(
+            "The query result is currently limited to {} sequences, use limit and offset to "
+            "fetch them in parts",
+            max_streamed_sequences
+         )
+      )
 
       response.set("data-version", fixed_database.database.getDataVersion().toString());
+      if (query_result.continuation_token.has_value()) {
+         response.set("continuation-token", query_result.continuation_token.value());
+      }
 
       response.setContentType("application/x-ndjson");
+      if (query_result.isStreamed()) {
+         response.setChunkedTransferEncoding(true);
+      }
       std::ostream& out_stream = response.send();
-      for (const auto& entry : query_result.query_result) {
-         out_stream << nlohmann::json(entry) << '\n';
+      // Once the headers are sent, errors can no longer be reported by the status of the response
+      try {
+         writeQueryResult(query_result, out_stream);
+      } catch (const std::exception& exception) {
+         SPDLOG_ERROR(
+            "Request Id [{}] - error after the response was sent, closing the connection: {}",
+            request_id,
+            exception.what()
+         );
+         abortResponse(request, response);
+      } catch (...) {
+         SPDLOG_ERROR(
+            "Request Id [{}] - unknown error after the response was sent, closing the connection",
+            request_id
+         );
+         abortResponse(request, response);
       }
    } catch (const silo::QueryParseException& ex) {
       response.setContentType("application/json");
@@ -43,7 +43,7 @@ Poco::Net::HTTPRequestHandler* SiloRequestHandlerFactory::routeRequest(
       return new silo_api::InfoHandler(database);
    }
    if (path == "/query") {
-      return new silo_api::QueryHandler(database);
+      return new silo_api::QueryHandler(database, runtime_config.max_streamed_sequences);
    }
    return new silo_api::NotFoundHandler;
 }
@@ -157,6 +157,58 @@ TEST_F(RequestHandlerTestFixture, handlesPostQueryRequest) {
    EXPECT_EQ(response.get("data-version"), "1234");
 }
 
+TEST_F(
+   RequestHandlerTestFixture,
+   givenStreamedResultFailsAfterSending_thenClosesConnectionWithoutSecondResponse
+) {
+   const std::map<std::string, JsonValueType> fields{{"someField", "value 1"}};
+   silo::query_engine::QueryResult query_result{{{fields}}};
+   query_result.next_chunk = []() -> std::vector<silo::query_engine::QueryResultEntry> {
+      throw std::runtime_error("failed to produce the next chunk");
+   };
+   EXPECT_CALL(database_mutex.mock_database, executeQuery)
+      .WillRepeatedly(testing::Return(query_result));
+   EXPECT_CALL(database_mutex.mock_database, getDataVersion)
+      .WillRepeatedly(testing::Return(silo::DataVersion::fromString("1234").value()));
+
+   request.setMethod("POST");
+   request.setURI("/query");
+
+   processRequest();
+
+   EXPECT_EQ(response.getStatus(), Poco::Net::HTTPResponse::HTTP_OK);
+   EXPECT_EQ(
+      response.out_stream.str(),
+      R"({"someField":"value 1"})"
+      "\n"
+   );
+   EXPECT_FALSE(response.getKeepAlive());
+}
+
+TEST_F(RequestHandlerTestFixture, givenStreamedResultExceedsLimit_thenReturnsBadRequest) {
+   silo::query_engine::QueryResult query_result;
+   query_result.next_chunk = []() { return std::vector<silo::query_engine::QueryResultEntry>(); };
+   query_result.streamed_entry_count = 3;
+   EXPECT_CALL(database_mutex.mock_database, executeQuery)
+      .WillRepeatedly(testing::Return(query_result));
+
+   request.setMethod("POST");
+   request.setURI("/query");
+
+   auto under_test = silo_api::SiloRequestHandlerFactory(
+      database_mutex, silo_api::RuntimeConfig{.max_streamed_sequences = 2}
+   );
+
+   processRequest(under_test);
+
+   EXPECT_EQ(response.getStatus(), Poco::Net::HTTPResponse::HTTP_BAD_REQUEST);
+   EXPECT_EQ(
+      response.out_stream.str(),
+      R"({"error":"Bad request","message":"The query result is currently limited to 2 )"
+      R"(sequences, use limit and offset to fetch them in parts"})"
+   );
+}
+
 TEST_F(RequestHandlerTestFixture, returnsMethodNotAllowedOnGetQuery) {
    request.setMethod("GET");
    request.setURI("/query");